@@ -0,0 +1,203 @@
+package main
+
+// Compares the linear-sampled blur of blur.fsh against the texelFetch blur it
+// replaced, by emulating both on the CPU at the bloom's 1080p size, with 8 bit
+// targets and 8 bit filter weights as the GPU has. Exits non-zero if they
+// differ by more than one level away from the top and bottom edges, where
+// clamp-to-edge now stands in for the black texelFetch read outside the
+// texture.
+//
+//	go run build/blurcheck.go
+
+import (
+	"fmt"
+	"math"
+	"math/rand"
+	"os"
+)
+
+const (
+	width  = 1920 / 8
+	height = 1080 / 8
+	radius = 4 // the Medium tier of game.c, the original bloom
+	sigma  = 2
+	passes = 3
+)
+
+// the table of the old blur.fsh
+var oldWeights = []float64{0.20236, 0.179044, 0.124009, 0.067234, 0.028532}
+
+type image [][]float64
+
+func newImage() image {
+	img := make(image, height)
+	for y := range img {
+		img[y] = make([]float64, width)
+	}
+	return img
+}
+
+func (img image) at(x, y int) float64 {
+	if x < 0 || x >= width || y < 0 || y >= height {
+		return 0
+	}
+	return img[y][x]
+}
+
+func clamp(v, lo, hi int) int {
+	if v < lo {
+		return lo
+	}
+	if v > hi {
+		return hi
+	}
+	return v
+}
+
+func (img image) clamped(x, y int) float64 {
+	return img[clamp(y, 0, height-1)][clamp(x, 0, width-1)]
+}
+
+// as written to an RGBA8 target
+func quantize(v float64) float64 {
+	return math.Round(math.Min(math.Max(v, 0), 1)*255) / 255
+}
+
+// blurKernel of game.c
+func blurKernel() (offsets, weights []float64) {
+	texels := make([]float64, radius+1)
+	total := 0.0
+	for i := 0; i <= radius; i++ {
+		scale := 1 / (sigma * math.Sqrt2)
+		texels[i] = (math.Erf((float64(i)+0.5)*scale) - math.Erf((float64(i)-0.5)*scale)) / 2
+		if i == 0 {
+			total += texels[i]
+		} else {
+			total += texels[i] * 2
+		}
+	}
+
+	offsets = []float64{0}
+	weights = []float64{texels[0] / total}
+	for i := 1; i <= radius; i += 2 {
+		a := texels[i]
+		b := 0.0
+		if i+1 <= radius {
+			b = texels[i+1]
+		}
+		offsets = append(offsets, (float64(i)*a+float64(i+1)*b)/(a+b))
+		weights = append(weights, (a+b)/total)
+	}
+	return offsets, weights
+}
+
+func oldPass(src image, horizontal bool) image {
+	dst := newImage()
+	for y := 0; y < height; y++ {
+		for x := 0; x < width; x++ {
+			sum := src.at(x, y) * oldWeights[0]
+			for i := 1; i < len(oldWeights); i++ {
+				if horizontal {
+					sum += (src.at(x+i, y) + src.at(x-i, y)) * oldWeights[i]
+				} else {
+					sum += (src.at(x, y+i) + src.at(x, y-i)) * oldWeights[i]
+				}
+			}
+			dst[y][x] = quantize(sum)
+		}
+	}
+	return dst
+}
+
+// a bilinear fetch at texel position p along the pass's axis, the fraction
+// rounded to 8 bits as texture units do
+func fetch(src image, x, y int, p float64, horizontal bool) float64 {
+	i := int(math.Floor(p))
+	f := math.Round((p-float64(i))*256) / 256
+	if horizontal {
+		return src.clamped(i, y)*(1-f) + src.clamped(i+1, y)*f
+	}
+	return src.clamped(x, i)*(1-f) + src.clamped(x, i+1)*f
+}
+
+func linearPass(src image, horizontal bool, offsets, weights []float64) image {
+	dst := newImage()
+	for y := 0; y < height; y++ {
+		for x := 0; x < width; x++ {
+			center := float64(y)
+			if horizontal {
+				center = float64(x)
+			}
+			sum := src[y][x] * weights[0]
+			for i := 1; i < len(offsets); i++ {
+				sum += fetch(src, x, y, center+offsets[i], horizontal) * weights[i]
+				sum += fetch(src, x, y, center-offsets[i], horizontal) * weights[i]
+			}
+			dst[y][x] = quantize(sum)
+		}
+	}
+	return dst
+}
+
+func main() {
+	offsets, weights := blurKernel()
+
+	// the texel weights blurKernel pairs up against the old table
+	maxWeightError := 0.0
+	for i := range oldWeights {
+		w := weights[0]
+		if i > 0 {
+			// tap t lies between texels 2t - 1 and 2t, nearer the heavier
+			tap := (i + 1) / 2
+			toSecond := offsets[tap] - float64(tap*2-1)
+			if i%2 == 1 {
+				w = (1 - toSecond) * weights[tap]
+			} else {
+				w = toSecond * weights[tap]
+			}
+		}
+		maxWeightError = math.Max(maxWeightError, math.Abs(w-oldWeights[i]))
+	}
+
+	// sparse bright lines like the thresholded playfield, black either side
+	random := rand.New(rand.NewSource(1))
+	input := newImage()
+	margin := (width - height) / 2
+	for y := 0; y < height; y++ {
+		for x := margin; x < width-margin; x++ {
+			if random.Float64() < 0.05 {
+				input[y][x] = quantize(random.Float64())
+			}
+		}
+	}
+
+	old, linear := input, input
+	for p := 0; p < passes; p++ {
+		horizontal := p%2 == 1
+		old = oldPass(old, horizontal)
+		linear = linearPass(linear, horizontal, offsets, weights)
+	}
+
+	// the edge difference spreads radius texels with each vertical pass
+	edge := radius * ((passes + 1) / 2)
+	maxDiff, interiorDiff, sumDiff := 0.0, 0.0, 0.0
+	for y := 0; y < height; y++ {
+		for x := 0; x < width; x++ {
+			d := math.Abs(old[y][x]-linear[y][x]) * 255
+			maxDiff = math.Max(maxDiff, d)
+			sumDiff += d
+			if y >= edge && y < height-edge {
+				interiorDiff = math.Max(interiorDiff, d)
+			}
+		}
+	}
+
+	fmt.Printf("%d taps, offsets %.4f\n", len(offsets), offsets)
+	fmt.Printf("texel weights within %.2g of the old table\n", maxWeightError)
+	fmt.Printf("%dx%d, %d passes: max diff %.0f levels, %.0f away from the edges, mean %.4f\n",
+		width, height, passes, maxDiff, interiorDiff, sumDiff/(width*height))
+	if maxWeightError > 1e-5 || interiorDiff > 1 {
+		fmt.Println("linear-sampled blur differs from the old blur")
+		os.Exit(1)
+	}
+}
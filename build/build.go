@@ -34,6 +34,8 @@ func main() {
 	runCommand("/usr/local/go/bin/go", "run", "build/model.go", "src")
 	// runCommand("/usr/local/bin/go", "run", "build/font.go", "src")
 	runCommand("/usr/local/go/bin/go", "run", "build/makematrix.go", "src/matrix.c")
+	// the linear-sampled bloom blur against the texelFetch one it replaced
+	runCommand("/usr/local/go/bin/go", "run", "build/blurcheck.go")
 	matches, err := filepath.Glob("src/*.c")
 	if err != nil {
 		log.Fatal(err)
@@ -44,4 +46,18 @@ func main() {
 	clangFormat("src/*.c")
 	clangFormat("src/*.vsh")
 	clangFormat("src/*.fsh")
+
+	// headless build of the simulation, no GL or windowing needed
+	runCommand("cc", "-std=gnu11", "-O2", "-pthread", "-o", "asteroids-headless",
+		"src/headless-main.c", "src/batch.c", "src/sim.c", "src/collision.c", "src/arena.c",
+		"src/matrix.c", "src/model.c", "src/util.c", "src/common.c",
+		"src/types.c", "src/profile.c", "-lm")
+	// fails the build if bullets tunnel through asteroids again
+	runCommand("./asteroids-headless", "swept")
+
+	// update() over full entity pools, see src/bench-main.c
+	runCommand("cc", "-std=gnu11", "-O2", "-pthread", "-o", "asteroids-bench",
+		"src/bench-main.c", "src/sim.c", "src/collision.c", "src/arena.c",
+		"src/matrix.c", "src/model.c", "src/util.c", "src/common.c",
+		"src/types.c", "src/profile.c", "-lm")
 }
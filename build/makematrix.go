@@ -88,13 +88,7 @@ float32 DegreesToRadians(float32 degrees) {
 		makeEq := func(template string, sep string) string {
 			parts := []string{}
 			for _, c := range components[:i] {
-				part := ""
-				if strings.Count(template, "%") == 1 {
-					part = fmt.Sprintf(template, c)
-				} else {
-					part = fmt.Sprintf(template, c, c)
-				}
-				parts = append(parts, part)
+				parts = append(parts, strings.Replace(template, "%s", c, -1))
 			}
 			return strings.Join(parts, " "+sep+" ")
 		}
@@ -197,13 +191,13 @@ float32 %tDotProduct(%t vl, %t vr) {
 %t %tMaximum(%t vl, %t vr) {
     return (%t){%s};
 }
-`, makeEq("(vl.%s > vr.%s) ? vl.x : vr.x", ","))
+`, makeEq("(vl.%s > vr.%s) ? vl.%s : vr.%s", ","))
 
 		makeFunc(`
 %t %tMinimum(%t vl, %t vr) {
     return (%t){%s};
 }
-`, makeEq("(vl.%s < vr.%s) ? vl.x : vr.x", ","))
+`, makeEq("(vl.%s < vr.%s) ? vl.%s : vr.%s", ","))
 	}
 
 	fmt.Fprint(out, `
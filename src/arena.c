@@ -0,0 +1,66 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+#if INTERFACE
+
+#define ArenaAlignment 64 // cache line, also enough for any SIMD load
+
+// bump allocator over a single block, an arena with no Base only measures how
+// much memory a sequence of arenaPush calls would need
+typedef struct {
+    uint8 *Base;
+    memory_index Size;
+    memory_index Used;
+} Arena;
+
+#endif
+
+Arena createArena(memory_index size) {
+    Arena arena = {
+        .Size = size,
+    };
+    if (size == 0) {
+        return arena;
+    }
+
+    void *base;
+    if (posix_memalign(&base, ArenaAlignment, size) != 0) {
+        fatal("failed to allocate arena of %zu bytes", size);
+    }
+    memset(base, 0, size);
+    arena.Base = base;
+    return arena;
+}
+
+void *arenaPush(Arena *arena, memory_index size) {
+    memory_index offset = (arena->Used + ArenaAlignment - 1) & ~(memory_index)(ArenaAlignment - 1);
+    if (arena->Base == NULL) {
+        arena->Used = offset + size;
+        return NULL;
+    }
+
+    if (offset + size > arena->Size) {
+        fatal("arena out of memory, %zu of %zu bytes used", offset + size, arena->Size);
+    }
+    arena->Used = offset + size;
+    return arena->Base + offset;
+}
+
+// carve a nested arena of size bytes out of arena, so that related data ends
+// up contiguous in the parent block
+Arena pushArena(Arena *arena, memory_index size) {
+    Arena child = {
+        .Base = arenaPush(arena, size),
+        .Size = size,
+    };
+    return child;
+}
+
+// forget everything pushed, for arenas holding data that lives one frame
+void resetArena(Arena *arena) {
+    arena->Used = 0;
+}
@@ -0,0 +1,15 @@
+/* This file was automatically generated.  Do not edit! */
+typedef uint8_t uint8;
+typedef size_t memory_index;
+typedef struct {
+    uint8 *Base;
+    memory_index Size;
+    memory_index Used;
+}Arena;
+void resetArena(Arena *arena);
+Arena pushArena(Arena *arena,memory_index size);
+void *arenaPush(Arena *arena,memory_index size);
+void fatal(const char *fmt,...);
+Arena createArena(memory_index size);
+#define ArenaAlignment 64 // cache line, also enough for any SIMD load
+#define INTERFACE 0
@@ -0,0 +1,278 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "batch.h"
+
+#if INTERFACE
+
+#define ObservedAsteroidCount 8
+#define BatchChunk 4 // games claimed at a time, small enough to balance uneven waves
+
+typedef struct {
+    V2 Offset; // from the ship, the short way around the playfield
+    V2 Velocity;
+    float32 Radius;
+} AsteroidObservation;
+
+// what a controller gets to see of one game after a step
+typedef struct {
+    V2 ShipPosition;
+    V2 ShipVelocity;
+    float32 ShipRotation;
+    int Score;
+    int Wave;
+    int AsteroidCount;
+    AsteroidObservation Asteroids[ObservedAsteroidCount]; // nearest first, unused are zero
+} GameObservation;
+
+// games not yet stepped in one worker's share of the batch, the owner and any
+// thief claim games from the front with the same atomic counter
+typedef struct {
+    _Alignas(ArenaAlignment) atomic_int Next;
+    int End;
+} BatchRange;
+
+typedef struct {
+    struct Batch *Batch;
+    int Index;
+    pthread_t Thread;
+} BatchWorker;
+
+// many independent games stepped in lockstep across all cores, each game and
+// its entity pools are contiguous in one arena
+typedef struct Batch {
+    int Count;
+    int WaveSize; // asteroids in the wave started when a game is cleared
+    Game **Games;
+    Arena Memory;
+
+    int WorkerCount; // including the thread calling stepBatch()
+    BatchWorker *Workers;
+    BatchRange *Ranges; // one per worker
+
+    // the step in progress
+    const GameInput *Inputs;
+    GameObservation *Observations;
+
+    pthread_mutex_t Lock;
+    pthread_cond_t Start;
+    pthread_cond_t Finish;
+    uint64 Generation; // bumped to start a step
+    int Busy;          // workers still running the current step
+    bool Quit;
+} Batch;
+
+#endif
+
+void observeGame(Game *game, GameObservation *observation) {
+    EntityPool *asteroids = &game->Asteroids;
+    V2 ship = game->Ship.Position[0];
+
+    *observation = (GameObservation){
+        .ShipPosition = ship,
+        .ShipVelocity = game->Ship.Velocity[0],
+        .ShipRotation = game->Ship.Rotation[0],
+        .Score = game->Score,
+        .Wave = game->Wave,
+    };
+
+    // insertion sort of the nearest asteroids by squared distance
+    float32 distances[ObservedAsteroidCount];
+    int length = 0;
+    for (int i = 0; i < asteroids->Count; i++) {
+        if (!asteroids->Active[i]) {
+            continue;
+        }
+        observation->AsteroidCount++;
+
+        V2 offset = wrapDelta(V2Subtract(asteroids->Position[i], ship));
+        float32 distance = V2DotProduct(offset, offset);
+        if (length == ObservedAsteroidCount && distance >= distances[length - 1]) {
+            continue;
+        }
+        int k = length < ObservedAsteroidCount ? length : ObservedAsteroidCount - 1;
+        for (; k > 0 && distances[k - 1] > distance; k--) {
+            distances[k] = distances[k - 1];
+            observation->Asteroids[k] = observation->Asteroids[k - 1];
+        }
+        distances[k] = distance;
+        observation->Asteroids[k] = (AsteroidObservation){
+            .Offset = offset,
+            .Velocity = asteroids->Velocity[i],
+            .Radius = entityRadius(asteroids, i),
+        };
+        if (length < ObservedAsteroidCount) {
+            length++;
+        }
+    }
+}
+
+void stepGame(Batch *batch, int index) {
+    Game *game = batch->Games[index];
+    game->Input = batch->Inputs[index];
+    update(game, game->TickDuration);
+    if (game->Asteroids.FreeCount == game->Asteroids.Count) {
+        spawnAsteroidWave(game, batch->WaveSize);
+    }
+    observeGame(game, &batch->Observations[index]);
+}
+
+// claim up to BatchChunk games from range, returns false once it is empty
+bool claimGames(Batch *batch, BatchRange *range) {
+    int start = atomic_fetch_add_explicit(&range->Next, BatchChunk, memory_order_relaxed);
+    if (start >= range->End) {
+        return false;
+    }
+    int end = start + BatchChunk < range->End ? start + BatchChunk : range->End;
+    for (int i = start; i < end; i++) {
+        stepGame(batch, i);
+    }
+    return true;
+}
+
+// step the worker's own range, then steal from the others until every range
+// is empty
+void runBatchWorker(Batch *batch, int index) {
+    while (claimGames(batch, &batch->Ranges[index])) {
+    }
+    for (int k = 1; k < batch->WorkerCount; k++) {
+        BatchRange *victim = &batch->Ranges[(index + k) % batch->WorkerCount];
+        while (claimGames(batch, victim)) {
+        }
+    }
+}
+
+void *batchThread(void *argument) {
+    BatchWorker *worker = argument;
+    Batch *batch = worker->Batch;
+
+    uint64 generation = 0;
+    for (;;) {
+        pthread_mutex_lock(&batch->Lock);
+        while (batch->Generation == generation && !batch->Quit) {
+            pthread_cond_wait(&batch->Start, &batch->Lock);
+        }
+        generation = batch->Generation;
+        bool quit = batch->Quit;
+        pthread_mutex_unlock(&batch->Lock);
+        if (quit) {
+            break;
+        }
+
+        runBatchWorker(batch, worker->Index);
+
+        pthread_mutex_lock(&batch->Lock);
+        batch->Busy--;
+        if (batch->Busy == 0) {
+            pthread_cond_signal(&batch->Finish);
+        }
+        pthread_mutex_unlock(&batch->Lock);
+    }
+    return NULL;
+}
+
+// set up count games with the same config and the threads to step them, a
+// workerCount of 0 uses every online core, game i is seeded with seed + i
+void createBatch(Batch *batch, int count, GameConfig config, int workerCount, float32 aspect, uint64 seed) {
+    if (workerCount <= 0) {
+        workerCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (workerCount < 1) {
+        workerCount = 1;
+    }
+
+    *batch = (Batch){
+        .Count = count,
+        .WaveSize = 4,
+        .WorkerCount = workerCount,
+    };
+
+    // each game struct is followed directly by its pools
+    memory_index gameSize = gameArenaSize(config);
+    Arena measure = {};
+    for (int i = 0; i < count; i++) {
+        arenaPush(&measure, sizeof(Game));
+        pushArena(&measure, gameSize);
+    }
+    batch->Memory = createArena(measure.Used);
+
+    batch->Games = malloc(count * sizeof(Game *));
+    for (int i = 0; i < count; i++) {
+        batch->Games[i] = arenaPush(&batch->Memory, sizeof(Game));
+        setupSimulation(batch->Games[i], config, pushArena(&batch->Memory, gameSize), aspect, seed + i);
+    }
+
+    if (posix_memalign((void **)&batch->Ranges, ArenaAlignment, workerCount * sizeof(BatchRange)) != 0) {
+        fatal("failed to allocate batch ranges");
+    }
+    batch->Workers = calloc(workerCount, sizeof(BatchWorker));
+    pthread_mutex_init(&batch->Lock, NULL);
+    pthread_cond_init(&batch->Start, NULL);
+    pthread_cond_init(&batch->Finish, NULL);
+
+    // worker 0 is whichever thread calls stepBatch()
+    for (int i = 1; i < workerCount; i++) {
+        batch->Workers[i] = (BatchWorker){
+            .Batch = batch,
+            .Index = i,
+        };
+        if (pthread_create(&batch->Workers[i].Thread, NULL, batchThread, &batch->Workers[i]) != 0) {
+            fatal("failed to start batch worker %d", i);
+        }
+    }
+}
+
+// step every game by one tick with inputs[i] held in game i, and write what
+// each game looks like afterwards to observations[i]
+void stepBatch(Batch *batch, const GameInput *inputs, GameObservation *observations) {
+    batch->Inputs = inputs;
+    batch->Observations = observations;
+
+    // even contiguous shares, so a worker that never steals only touches its
+    // own slice of the arena
+    for (int i = 0; i < batch->WorkerCount; i++) {
+        atomic_store_explicit(&batch->Ranges[i].Next, (int)((int64)batch->Count * i / batch->WorkerCount), memory_order_relaxed);
+        batch->Ranges[i].End = (int)((int64)batch->Count * (i + 1) / batch->WorkerCount);
+    }
+
+    pthread_mutex_lock(&batch->Lock);
+    batch->Busy = batch->WorkerCount - 1;
+    batch->Generation++;
+    pthread_cond_broadcast(&batch->Start);
+    pthread_mutex_unlock(&batch->Lock);
+
+    runBatchWorker(batch, 0);
+
+    pthread_mutex_lock(&batch->Lock);
+    while (batch->Busy > 0) {
+        pthread_cond_wait(&batch->Finish, &batch->Lock);
+    }
+    pthread_mutex_unlock(&batch->Lock);
+}
+
+void destroyBatch(Batch *batch) {
+    pthread_mutex_lock(&batch->Lock);
+    batch->Quit = true;
+    pthread_cond_broadcast(&batch->Start);
+    pthread_mutex_unlock(&batch->Lock);
+    for (int i = 1; i < batch->WorkerCount; i++) {
+        pthread_join(batch->Workers[i].Thread, NULL);
+    }
+
+    for (int i = 0; i < batch->Count; i++) {
+        free(batch->Games[i]->AsteroidGrid.Items);
+    }
+    free(batch->Games);
+    free(batch->Memory.Base);
+    free(batch->Ranges);
+    free(batch->Workers);
+    pthread_mutex_destroy(&batch->Lock);
+    pthread_cond_destroy(&batch->Start);
+    pthread_cond_destroy(&batch->Finish);
+}
@@ -0,0 +1,185 @@
+/* This file was automatically generated.  Do not edit! */
+typedef struct Batch Batch;
+typedef uint8_t uint8;
+typedef size_t memory_index;
+typedef struct {
+    uint8 *Base;
+    memory_index Size;
+    memory_index Used;
+}Arena;
+typedef float float32;
+typedef union {
+    struct {
+        float32 x;
+        float32 y;
+    };
+    float32 m[2];
+}V2;
+typedef struct {
+    float32 m[9];
+}M3;
+typedef double float64;
+typedef struct {
+    int Width;
+    int Height;
+    int Length;
+    V2 *Data;
+}Model;
+typedef uint64_t uint64;
+#define MaxTextLength 8 // characters in a text entity, including the terminator
+typedef struct {
+    int Count;
+    int FreeCount;
+    int *Free; // stack of inactive indices, spawnEntity pops and despawnEntity pushes
+    bool *Active;
+    V2 *Position;
+    V2 *Velocity;
+    float32 *Rotation;
+    V2 *PreviousPosition; // at the start of the last tick, for render interpolation
+    float32 *PreviousRotation;
+    float32 *RotationSpeed;
+    M3 *Transform;
+    float32 *Intensity;
+    float64 *Created;
+    Model *Model;
+    int *AsteroidSize;
+    float32 *Radius; // model space bounding radius around the model center
+
+    // per tick cache of the collision polygon, only allocated for pools that
+    // are tested with collision()
+    int PolygonStride;
+    uint64 *PolygonTick;
+    V2 *Polygon;
+
+    // only for the text pool, the string each entity shows, its Model only
+    // has the size
+    char (*Text)[MaxTextLength];
+}EntityPool;
+#define GridSize 16 // cells per axis over the wrapped [-1, 1] playfield
+#define GridCellCount (GridSize * GridSize)
+typedef struct {
+    int CellStart[GridCellCount + 1]; // Items[CellStart[c]..CellStart[c + 1]] are in cell c
+    int Length;
+    int Capacity;
+    int *Items; // entity indices sorted by cell
+}Grid;
+typedef uint32_t uint32;
+typedef struct {
+    uint32 Words[4];
+}Random;
+#define RandomLaneCount 8
+typedef struct {
+    uint32 Words[4][RandomLaneCount];
+}RandomLanes;
+typedef struct {
+    bool RotateLeft;
+    bool RotateRight;
+    bool Fire;
+    bool Accelerate;
+}GameInput;
+typedef struct {
+    Arena Memory; // backs every EntityPool
+    EntityPool Asteroids;
+    EntityPool Bullets;
+    EntityPool Ship;
+    EntityPool ExplosionParticles;
+    EntityPool Texts;
+    Grid AsteroidGrid;
+    int ScoreText;  // index into Texts
+    int ShownScore; // the score ScoreText shows
+    M3 Projection;
+
+    Random Random;
+    RandomLanes ParticleRandom; // for bulk draws when spawning particles
+
+    GameInput Input;
+    int Score;
+    int Wave;
+    float64 Time;
+    float64 TickDuration;
+    float64 Accumulator; // time passed to advanceSimulation() not yet simulated
+    float64 LastBulletTime;
+    uint64 Tick; // number of update() calls, starts at 1 so that 0 is never current
+
+    // counters for checking the effectiveness of the polygon cache and
+    // bounding circle rejection under load
+    int PolygonCacheHits;
+    int PolygonCacheMisses;
+    int BoundingCircleRejects;
+}Game;
+typedef struct {
+    struct Batch *Batch;
+    int Index;
+    pthread_t Thread;
+}BatchWorker;
+#define ArenaAlignment 64 // cache line, also enough for any SIMD load
+typedef struct {
+    _Alignas(ArenaAlignment) atomic_int Next;
+    int End;
+}BatchRange;
+typedef struct {
+    V2 Offset; // from the ship, the short way around the playfield
+    V2 Velocity;
+    float32 Radius;
+}AsteroidObservation;
+#define ObservedAsteroidCount 8
+typedef struct {
+    V2 ShipPosition;
+    V2 ShipVelocity;
+    float32 ShipRotation;
+    int Score;
+    int Wave;
+    int AsteroidCount;
+    AsteroidObservation Asteroids[ObservedAsteroidCount]; // nearest first, unused are zero
+}GameObservation;
+struct Batch {
+    int Count;
+    int WaveSize; // asteroids in the wave started when a game is cleared
+    Game **Games;
+    Arena Memory;
+
+    int WorkerCount; // including the thread calling stepBatch()
+    BatchWorker *Workers;
+    BatchRange *Ranges; // one per worker
+
+    // the step in progress
+    const GameInput *Inputs;
+    GameObservation *Observations;
+
+    pthread_mutex_t Lock;
+    pthread_cond_t Start;
+    pthread_cond_t Finish;
+    uint64 Generation; // bumped to start a step
+    int Busy;          // workers still running the current step
+    bool Quit;
+};
+void destroyBatch(Batch *batch);
+typedef int64_t int64;
+void stepBatch(Batch *batch,const GameInput *inputs,GameObservation *observations);
+void fatal(const char *fmt,...);
+typedef struct {
+    int TickRate; // updates per second, independent of the display
+    int AsteroidCount;
+    int BulletCount;
+    int TextCount;
+    int ExplosionParticleCount;
+}GameConfig;
+void setupSimulation(Game *game,GameConfig config,Arena arena,float32 aspect,uint64 seed);
+Arena createArena(memory_index size);
+Arena pushArena(Arena *arena,memory_index size);
+void *arenaPush(Arena *arena,memory_index size);
+memory_index gameArenaSize(GameConfig config);
+void createBatch(Batch *batch,int count,GameConfig config,int workerCount,float32 aspect,uint64 seed);
+void *batchThread(void *argument);
+void runBatchWorker(Batch *batch,int index);
+bool claimGames(Batch *batch,BatchRange *range);
+void spawnAsteroidWave(Game *game,int count);
+void update(Game *game,float64 deltaT);
+void stepGame(Batch *batch,int index);
+float32 entityRadius(EntityPool *pool,int index);
+float32 V2DotProduct(V2 vl,V2 vr);
+V2 V2Subtract(V2 vl,V2 vr);
+V2 wrapDelta(V2 delta);
+void observeGame(Game *game,GameObservation *observation);
+#define BatchChunk 4 // games claimed at a time, small enough to balance uneven waves
+#define INTERFACE 0
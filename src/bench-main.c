@@ -0,0 +1,102 @@
+// Times update() of a single game with its pools filled, to compare changes
+// to the entity store and the integration pass at entity counts far beyond
+// the interactive game's.  Built by build/build.go, or by hand with:
+//
+//   cc -std=gnu11 -O2 -pthread -o asteroids-bench src/bench-main.c
+//      src/sim.c src/collision.c src/arena.c src/matrix.c src/model.c
+//      src/util.c src/common.c src/types.c src/profile.c -lm
+//
+// usage: asteroids-bench [asteroids] [particles] [ticks] [seed]
+//
+// The defaults, 8192 asteroids and 4096 particles, are the 12k entity load
+// update() was tuned for.
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "bench-main.h"
+
+#define BenchAspect (16.0 / 9.0)
+
+int activeEntities(Game *game) {
+    EntityPool *pools[EntityPoolCount];
+    gameEntityPools(game, pools);
+    int count = 0;
+    for (int i = 0; i < EntityPoolCount; i++) {
+        count += pools[i]->Count - pools[i]->FreeCount;
+    }
+    return count;
+}
+
+int main(int argc, char *argv[]) {
+    int asteroids = 8192;
+    int particles = 4096;
+    int64 ticks = 2000;
+    uint64 seed = 1;
+    if (argc > 1) {
+        asteroids = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        particles = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        ticks = atoll(argv[3]);
+    }
+    if (argc > 4) {
+        seed = strtoull(argv[4], NULL, 10);
+    }
+
+    GameConfig config = Config;
+    config.AsteroidCount = asteroids;
+    config.ExplosionParticleCount = particles;
+    config.TextCount = 0;
+
+    Game game;
+    setupSimulation(&game, config, createArena(gameArenaSize(config)), BenchAspect, seed);
+
+    // every pool full, with particles that never expire, so that the load
+    // stays the same throughout, the ship still destroys what drifts into it
+    spawnAsteroidWave(&game, game.Asteroids.FreeCount);
+    Random random = seedRandom(~seed);
+    while (game.ExplosionParticles.FreeCount > 0) {
+        Entity particle = {
+            .Active = true,
+            .Position = (V2){Rand(&random, -1, 1), Rand(&random, -1, 1)},
+            .Velocity = (V2){Rand(&random, -0.2, 0.2), Rand(&random, -0.2, 0.2)},
+            .Created = INFINITY,
+            .Intensity = 0.5,
+            .Model = ModelBullet,
+        };
+        spawnEntity(&game.ExplosionParticles, particle);
+    }
+    int entities = activeEntities(&game);
+
+    float64 deltaT = game.TickDuration;
+    uint64 start = profileTime();
+    for (int64 tick = 0; tick < ticks; tick++) {
+        update(&game, deltaT);
+    }
+    float64 updateTime = (profileTime() - start) * 1e-3 / ticks;
+
+    // the pass the entity store is laid out for, on its own
+    EntityPool *pools[EntityPoolCount];
+    gameEntityPools(&game, pools);
+    start = profileTime();
+    for (int64 tick = 0; tick < ticks; tick++) {
+        for (int i = 0; i < EntityPoolCount; i++) {
+            integrateEntities(pools[i], deltaT);
+            transformEntities(pools[i], game.Projection);
+        }
+    }
+    float64 integrateTime = (profileTime() - start) * 1e-3 / ticks;
+
+    printf("%d entities, %d left after %lld ticks at %d Hz\n", entities, activeEntities(&game), (long long)ticks, config.TickRate);
+    printf("update %.1f us per tick, integrate and transform %.1f us per tick\n", updateTime, integrateTime);
+    printf("polygon cache %d hits, %d misses, %d bounding circle rejects\n",
+           game.PolygonCacheHits, game.PolygonCacheMisses, game.BoundingCircleRejects);
+    return EXIT_SUCCESS;
+}
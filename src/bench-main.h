@@ -0,0 +1,146 @@
+/* This file was automatically generated.  Do not edit! */
+typedef float float32;
+typedef union {
+    struct {
+        float32 x;
+        float32 y;
+    };
+    float32 m[2];
+}V2;
+typedef struct {
+    float32 m[9];
+}M3;
+typedef double float64;
+typedef struct {
+    int Width;
+    int Height;
+    int Length;
+    V2 *Data;
+}Model;
+typedef uint64_t uint64;
+#define MaxTextLength 8 // characters in a text entity, including the terminator
+typedef struct {
+    int Count;
+    int FreeCount;
+    int *Free; // stack of inactive indices, spawnEntity pops and despawnEntity pushes
+    bool *Active;
+    V2 *Position;
+    V2 *Velocity;
+    float32 *Rotation;
+    V2 *PreviousPosition; // at the start of the last tick, for render interpolation
+    float32 *PreviousRotation;
+    float32 *RotationSpeed;
+    M3 *Transform;
+    float32 *Intensity;
+    float64 *Created;
+    Model *Model;
+    int *AsteroidSize;
+    float32 *Radius; // model space bounding radius around the model center
+
+    // per tick cache of the collision polygon, only allocated for pools that
+    // are tested with collision()
+    int PolygonStride;
+    uint64 *PolygonTick;
+    V2 *Polygon;
+
+    // only for the text pool, the string each entity shows, its Model only
+    // has the size
+    char (*Text)[MaxTextLength];
+}EntityPool;
+void transformEntities(EntityPool *pool,M3 projection);
+void integrateEntities(EntityPool *pool,float64 deltaT);
+typedef uint8_t uint8;
+typedef size_t memory_index;
+typedef struct {
+    uint8 *Base;
+    memory_index Size;
+    memory_index Used;
+}Arena;
+#define GridSize 16 // cells per axis over the wrapped [-1, 1] playfield
+#define GridCellCount (GridSize * GridSize)
+typedef struct {
+    int CellStart[GridCellCount + 1]; // Items[CellStart[c]..CellStart[c + 1]] are in cell c
+    int Length;
+    int Capacity;
+    int *Items; // entity indices sorted by cell
+}Grid;
+typedef uint32_t uint32;
+typedef struct {
+    uint32 Words[4];
+}Random;
+#define RandomLaneCount 8
+typedef struct {
+    uint32 Words[4][RandomLaneCount];
+}RandomLanes;
+typedef struct {
+    bool RotateLeft;
+    bool RotateRight;
+    bool Fire;
+    bool Accelerate;
+}GameInput;
+typedef struct {
+    Arena Memory; // backs every EntityPool
+    EntityPool Asteroids;
+    EntityPool Bullets;
+    EntityPool Ship;
+    EntityPool ExplosionParticles;
+    EntityPool Texts;
+    Grid AsteroidGrid;
+    int ScoreText;  // index into Texts
+    int ShownScore; // the score ScoreText shows
+    M3 Projection;
+
+    Random Random;
+    RandomLanes ParticleRandom; // for bulk draws when spawning particles
+
+    GameInput Input;
+    int Score;
+    int Wave;
+    float64 Time;
+    float64 TickDuration;
+    float64 Accumulator; // time passed to advanceSimulation() not yet simulated
+    float64 LastBulletTime;
+    uint64 Tick; // number of update() calls, starts at 1 so that 0 is never current
+
+    // counters for checking the effectiveness of the polygon cache and
+    // bounding circle rejection under load
+    int PolygonCacheHits;
+    int PolygonCacheMisses;
+    int BoundingCircleRejects;
+}Game;
+void update(Game *game,float64 deltaT);
+uint64 profileTime();
+typedef struct {
+    bool Active;
+    V2 Position;
+    V2 Velocity;
+    float32 Intensity;
+    float32 Rotation;      // radians
+    float32 RotationSpeed; // radians per second
+    Model Model;
+    float64 Created;
+    M3 Transform;
+    int AsteroidSize;
+}Entity;
+int spawnEntity(EntityPool *pool,Entity e);
+extern Model ModelBullet;
+float32 Rand(Random *random,float32 min,float32 max);
+Random seedRandom(uint64 seed);
+void spawnAsteroidWave(Game *game,int count);
+typedef struct {
+    int TickRate; // updates per second, independent of the display
+    int AsteroidCount;
+    int BulletCount;
+    int TextCount;
+    int ExplosionParticleCount;
+}GameConfig;
+memory_index gameArenaSize(GameConfig config);
+Arena createArena(memory_index size);
+void setupSimulation(Game *game,GameConfig config,Arena arena,float32 aspect,uint64 seed);
+extern GameConfig Config;
+typedef int64_t int64;
+int main(int argc,char *argv[]);
+int main(int argc,char *argv[]);
+#define EntityPoolCount 5
+void gameEntityPools(Game *game,EntityPool *pools[EntityPoolCount]);
+int activeEntities(Game *game);
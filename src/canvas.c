@@ -2,6 +2,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #if TARGET_OS_IPHONE
 #include <OpenGLES/ES3/gl.h>
@@ -13,14 +14,20 @@
 
 #if INTERFACE
 
-#define DRAW_COMMANDS_COUNT 1024
+#define CanvasStreamSize (64 * 1024) // bytes of canvas vertices expected per frame
 
+typedef struct {
+    V2 XY;
+    V2 UV;
+    uint8 Color[4];
+} CanvasVertex;
+
+// a run of consecutive canvas vertices sampling the same texture
 typedef struct {
     GLuint Texture;
-    V4 Color;
-    size_t Length;
-    float32 *Data;
-} DrawCommand;
+    GLint First;
+    GLsizei Count;
+} CanvasBatch;
 
 #endif
 
@@ -35,21 +42,31 @@ GLuint WhiteTexture = INVALID;
 
 GLuint CanvasProgram = INVALID;
 GLuint CanvasVertexArray = INVALID;
-GLuint CanvasBuffer = INVALID;
 GLuint CanvasResolution = INVALID;
-GLuint CanvasColor = INVALID;
+GLuint CanvasAttribXY = INVALID;
+GLuint CanvasAttribUV = INVALID;
+GLuint CanvasAttribColor = INVALID;
+
+GLuint CanvasStream; // buffer holding the frame's canvas vertices
+GLintptr CanvasOffset;
 
 V4 DrawColor;
 Font DrawFont;
 
-DrawCommand DrawCommands[DRAW_COMMANDS_COUNT];
-int DrawCommandsLength = 0;
+// everything drawn since initCanvas(), in FrameArena, the capacities carry
+// over so that a steady HUD reserves its arrays once per frame
+CanvasVertex *CanvasVertices;
+int CanvasVertexCount;
+int CanvasVertexCapacity;
+CanvasBatch *CanvasBatches;
+int CanvasBatchCount;
+int CanvasBatchCapacity;
 
 void setupCanvas() {
     DrawFont = Terminus32Medium;
 
     glGenTextures(1, &FontTexture);
-    glBindTexture(GL_TEXTURE_2D, FontTexture);
+    setTexture(0, FontTexture);
     glLabelObject(GL_TEXTURE, FontTexture, "Font");
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -58,7 +75,7 @@ void setupCanvas() {
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, DrawFont.Width * DrawFont.Chars, DrawFont.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, DrawFont.Data);
 
     glGenTextures(1, &WhiteTexture);
-    glBindTexture(GL_TEXTURE_2D, WhiteTexture);
+    setTexture(0, WhiteTexture);
     glLabelObject(GL_TEXTURE, WhiteTexture, "White");
     uint8 whiteData[] = {
         255, 255, 255, 255,
@@ -66,55 +83,104 @@ void setupCanvas() {
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, whiteData);
 
     CanvasProgram = compileProgram(CanvasVertexSource, CanvasFragmentSource, "Canvas");
-    CanvasColor = glGetUniformLocation(CanvasProgram, "color");
     CanvasResolution = glGetUniformLocation(CanvasProgram, "resolution");
 
+    // the attributes are pointed at the frame's vertices in renderCanvas()
     glGenVertexArrays(1, &CanvasVertexArray);
-    glBindVertexArray(CanvasVertexArray);
+    setVertexArray(CanvasVertexArray);
+    CanvasAttribXY = glGetAttribLocation(CanvasProgram, "xy");
+    glEnableVertexAttribArray(CanvasAttribXY);
+    CanvasAttribUV = glGetAttribLocation(CanvasProgram, "uv");
+    glEnableVertexAttribArray(CanvasAttribUV);
+    CanvasAttribColor = glGetAttribLocation(CanvasProgram, "vertexColor");
+    glEnableVertexAttribArray(CanvasAttribColor);
+}
 
-    glGenBuffers(1, &CanvasBuffer);
-    glBindBuffer(GL_ARRAY_BUFFER, CanvasBuffer);
+// after FrameArena is reset
+void initCanvas() {
+    if (CanvasVertexCapacity == 0) {
+        CanvasVertexCapacity = CanvasStreamSize / sizeof(CanvasVertex);
+        CanvasBatchCapacity = 16;
+    }
+    CanvasVertices = arenaPush(&FrameArena, CanvasVertexCapacity * sizeof(CanvasVertex));
+    CanvasVertexCount = 0;
+    CanvasBatches = arenaPush(&FrameArena, CanvasBatchCapacity * sizeof(CanvasBatch));
+    CanvasBatchCount = 0;
+    DrawColor = (V4){1, 1, 1, 1};
+}
 
-    int32 stride = sizeof(float32) * 4;
+// copy of the length bytes at data with room for capacity bytes, further on
+// in FrameArena
+void *growFrameArray(void *data, size_t length, size_t capacity) {
+    void *grown = arenaPush(&FrameArena, capacity);
+    memcpy(grown, data, length);
+    return grown;
+}
 
-    GLuint xy = glGetAttribLocation(CanvasProgram, "xy");
-    glEnableVertexAttribArray(xy);
-    glVertexAttribPointer(xy, 2, GL_FLOAT, GL_FALSE, stride, BUFFER_OFFSET(0));
+// room for count more vertices sampling texture, merged into the last batch
+// when it uses the same texture
+CanvasVertex *pushCanvasVertices(GLuint texture, int count) {
+    if (CanvasVertexCount + count > CanvasVertexCapacity) {
+        while (CanvasVertexCount + count > CanvasVertexCapacity) {
+            CanvasVertexCapacity *= 2;
+        }
+        CanvasVertices = growFrameArray(CanvasVertices, CanvasVertexCount * sizeof(CanvasVertex), CanvasVertexCapacity * sizeof(CanvasVertex));
+    }
 
-    GLuint uv = glGetAttribLocation(CanvasProgram, "uv");
-    glEnableVertexAttribArray(uv);
-    glVertexAttribPointer(uv, 2, GL_FLOAT, GL_FALSE, stride, BUFFER_OFFSET(2 * sizeof(float)));
+    if (CanvasBatchCount == 0 || CanvasBatches[CanvasBatchCount - 1].Texture != texture) {
+        if (CanvasBatchCount == CanvasBatchCapacity) {
+            CanvasBatchCapacity *= 2;
+            CanvasBatches = growFrameArray(CanvasBatches, CanvasBatchCount * sizeof(CanvasBatch), CanvasBatchCapacity * sizeof(CanvasBatch));
+        }
+        CanvasBatches[CanvasBatchCount] = (CanvasBatch){
+            .Texture = texture,
+            .First = CanvasVertexCount,
+        };
+        CanvasBatchCount++;
+    }
+    CanvasBatches[CanvasBatchCount - 1].Count += count;
+
+    CanvasVertex *vertices = &CanvasVertices[CanvasVertexCount];
+    CanvasVertexCount += count;
+    return vertices;
 }
 
-void initCanvas() {
-    for (int i = 0; i < DrawCommandsLength; i++) {
-        DrawCommand cmd = DrawCommands[i];
-        free(cmd.Data);
-        DrawCommands[i] = (DrawCommand){};
+// two triangles covering the rectangle xy0 to xy1, textured from uv0 to uv1
+// and tinted with DrawColor
+void pushCanvasQuad(GLuint texture, V2 xy0, V2 xy1, V2 uv0, V2 uv1) {
+    uint8 color[4];
+    for (int i = 0; i < 4; i++) {
+        float32 c = DrawColor.m[i] < 0 ? 0 : DrawColor.m[i] > 1 ? 1 : DrawColor.m[i];
+        color[i] = (uint8)(c * 255 + 0.5f);
     }
-    DrawCommandsLength = 0;
-    DrawColor = (V4){1, 1, 1, 1};
-}
 
-void drawText(char *text, int x, int y) {
-    size_t textLength = strlen(text);
-    size_t charWidthFloats = 2 * 3 * 4; // 2 triangles * 3 vertices * 4 floats per vertex
-    size_t length = textLength * charWidthFloats;
-
-    DrawCommand cmd = {
-        .Texture = FontTexture,
-        .Color = DrawColor,
-        .Length = length,
-        .Data = malloc(length * sizeof(float32)),
+    CanvasVertex corners[] = {
+        // bottom left
+        {{xy0.x, xy0.y}, {uv0.x, uv0.y}},
+        // top left
+        {{xy0.x, xy1.y}, {uv0.x, uv1.y}},
+        // bottom right
+        {{xy1.x, xy0.y}, {uv1.x, uv0.y}},
+        // top right
+        {{xy1.x, xy1.y}, {uv1.x, uv1.y}},
     };
+    int order[] = {0, 1, 2, 2, 1, 3};
 
+    CanvasVertex *vertices = pushCanvasVertices(texture, 6);
+    for (int i = 0; i < 6; i++) {
+        vertices[i] = corners[order[i]];
+        memcpy(vertices[i].Color, color, sizeof(color));
+    }
+}
+
+void drawText(char *text, int x, int y) {
     float32 vbottom = (0.0 + 0.5) / (float32)DrawFont.Height;
     float32 vtop = (DrawFont.Height - 1 + 0.5) / (float32)DrawFont.Height;
 
     float32 ybottom = y;
     float32 ytop = y + DrawFont.Height;
 
-    for (int i = 0; i < textLength; i++) {
+    for (int i = 0; text[i] != '\0'; i++) {
         float32 xleft = x;
         float32 xright = x + DrawFont.Width;
 
@@ -122,93 +188,46 @@ void drawText(char *text, int x, int y) {
         float32 uleft = (uoffset + 0.5) / (float32)(DrawFont.Width * DrawFont.Chars);
         float32 uright = (uoffset + DrawFont.Width - 1 + 0.5) / (float32)(DrawFont.Width * DrawFont.Chars);
 
-        float32 data[] = {
-            // bottom left
-            xleft, ybottom,
-            uleft, vbottom,
-            // top left
-            xleft, ytop,
-            uleft, vtop,
-            // bottom right
-            xright, ybottom,
-            uright, vbottom,
-            // bottom right
-            xright, ybottom,
-            uright, vbottom,
-            // top left
-            xleft, ytop,
-            uleft, vtop,
-            // top right
-            xright, ytop,
-            uright, vtop,
-        };
-        memcpy(cmd.Data + i * charWidthFloats, data, charWidthFloats * sizeof(float32));
+        pushCanvasQuad(FontTexture, (V2){xleft, ybottom}, (V2){xright, ytop}, (V2){uleft, vbottom}, (V2){uright, vtop});
         x += DrawFont.Width;
     }
-    DrawCommands[DrawCommandsLength] = cmd;
-    DrawCommandsLength++;
 }
 
 void drawBox(int x, int y, int width, int height) {
-    size_t length = 2 * 3 * 4; // 2 triangles * 3 vertices * 4 floats per vertex
-
-    DrawCommand cmd = {
-        .Texture = WhiteTexture,
-        .Color = DrawColor,
-        .Length = length,
-        .Data = malloc(length * sizeof(float32)),
-    };
-
-    float32 ybottom = y;
-    float32 ytop = y + height;
-
-    float32 xleft = x;
-    float32 xright = x + width;
+    pushCanvasQuad(WhiteTexture, (V2){x, y}, (V2){x + width, y + height}, (V2){0, 0}, (V2){0, 0});
+}
 
-    float32 data[] = {
-        // bottom left
-        xleft, ybottom,
-        0, 0,
-        // top left
-        xleft, ytop,
-        0, 0,
-        // bottom right
-        xright, ybottom,
-        0, 0,
-        // bottom right
-        xright, ybottom,
-        0, 0,
-        // top left
-        xleft, ytop,
-        0, 0,
-        // top right
-        xright, ytop,
-        0, 0,
-    };
-    memcpy(cmd.Data, data, length * sizeof(float32));
-    DrawCommands[DrawCommandsLength] = cmd;
-    DrawCommandsLength++;
+// copy everything drawn so far into stream, before anything of the frame is
+// drawn
+void streamCanvas(StreamBuffer *stream) {
+    CanvasVertex *data;
+    CanvasStream = stream->Buffer;
+    GLintptr offset = streamAlloc(stream, CanvasVertexCount * sizeof(CanvasVertex), (void **)&data);
+    CanvasOffset = stream->Base + offset; // Base moves if the stream grows
+    memcpy(data, CanvasVertices, CanvasVertexCount * sizeof(CanvasVertex));
 }
 
 void renderCanvas() {
-    glUseProgram(CanvasProgram);
-    glBindVertexArray(CanvasVertexArray);
-    glBindBuffer(GL_ARRAY_BUFFER, CanvasBuffer);
+    pushProfile("renderCanvas");
+    setProgram(CanvasProgram);
+    setVertexArray(CanvasVertexArray);
     glUniform2f(CanvasResolution, ScreenWidth, ScreenHeight);
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLsizei stride = sizeof(CanvasVertex);
+    glBindBuffer(GL_ARRAY_BUFFER, CanvasStream);
+    glVertexAttribPointer(CanvasAttribXY, 2, GL_FLOAT, GL_FALSE, stride, BUFFER_OFFSET(CanvasOffset + offsetof(CanvasVertex, XY)));
+    glVertexAttribPointer(CanvasAttribUV, 2, GL_FLOAT, GL_FALSE, stride, BUFFER_OFFSET(CanvasOffset + offsetof(CanvasVertex, UV)));
+    glVertexAttribPointer(CanvasAttribColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, BUFFER_OFFSET(CanvasOffset + offsetof(CanvasVertex, Color)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    for (int i = 0; i < DrawCommandsLength; i++) {
-        DrawCommand cmd = DrawCommands[i];
+    setBlend(true);
+    setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-        glUniform4fv(CanvasColor, 1, cmd.Color.m);
-        glBufferData(GL_ARRAY_BUFFER, cmd.Length * sizeof(float32), cmd.Data, GL_DYNAMIC_DRAW);
-        glBindTexture(GL_TEXTURE_2D, cmd.Texture);
-        glDrawArrays(GL_TRIANGLES, 0, (int)cmd.Length / 4);
-        glBindTexture(GL_TEXTURE_2D, 0);
+    for (int i = 0; i < CanvasBatchCount; i++) {
+        CanvasBatch batch = CanvasBatches[i];
+        setTexture(0, batch.Texture);
+        glDrawArrays(GL_TRIANGLES, batch.First, batch.Count);
     }
-
-    glDisable(GL_BLEND);
-    glBlendFunc(GL_ONE, GL_ZERO);
-}
\ No newline at end of file
+    setBlend(false);
+    popProfile();
+}
@@ -1,17 +1,67 @@
 /* This file was automatically generated.  Do not edit! */
+void popProfile();
+void setBlendFunc(GLenum source,GLenum destination);
+void setBlend(bool enabled);
+#define BUFFER_OFFSET(i) ((char *)NULL + (i))
 extern int ScreenHeight;
 extern int ScreenWidth;
+void setProgram(GLuint program);
+void pushProfile(const char *name);
 void renderCanvas();
+#define StreamFrameCount 3     // frames the GPU may still be reading while the next is written
+typedef uint8_t uint8;
+typedef size_t memory_index;
+typedef struct {
+    uint8 *Base;
+    memory_index Size;
+    memory_index Used;
+}Arena;
+typedef uint64_t uint64;
+typedef struct {
+    GLuint Buffer;
+    GLsizeiptr FrameSize;
+    int Frame;
+    GLsync Fences[StreamFrameCount];
+    Arena *Scratch; // per frame memory, holds the written data while the buffer grows
+
+    // the frame being written, offsets from streamAlloc() are relative to Base
+    GLintptr Base;
+    uint8 *Mapped;
+    GLsizeiptr Used;
+
+    GLsizeiptr FrameBytes; // streamed by the last finished frame
+    uint64 TotalBytes;
+    int Stalls; // frames that had to wait for the GPU to release their region
+}StreamBuffer;
+GLintptr streamAlloc(StreamBuffer *stream,GLsizeiptr size,void **data);
+void streamCanvas(StreamBuffer *stream);
 void drawBox(int x,int y,int width,int height);
 void drawText(char *text,int x,int y);
+typedef float float32;
+typedef union {
+    struct {
+        float32 x;
+        float32 y;
+    };
+    float32 m[2];
+}V2;
+void pushCanvasQuad(GLuint texture,V2 xy0,V2 xy1,V2 uv0,V2 uv1);
+typedef struct {
+    V2 XY;
+    V2 UV;
+    uint8 Color[4];
+}CanvasVertex;
+CanvasVertex *pushCanvasVertices(GLuint texture,int count);
+void *growFrameArray(void *data,size_t length,size_t capacity);
+extern Arena FrameArena;
+void *arenaPush(Arena *arena,memory_index size);
 void initCanvas();
-#define BUFFER_OFFSET(i) ((char *)NULL + (i))
-typedef int32_t int32;
+void setVertexArray(GLuint array);
 extern const char *const CanvasFragmentSource;
 extern const char *const CanvasVertexSource;
 GLuint compileProgram(const char *const vertexShaderSource,const char *const fragmentShaderSource,char *name);
-typedef uint8_t uint8;
 void glLabelObject(GLenum type,GLuint object,char *label);
+void setTexture(int unit,GLuint texture);
 typedef struct {
     int Width;
     int Height;
@@ -20,8 +70,18 @@ typedef struct {
 }Font;
 extern Font Terminus32Medium;
 void setupCanvas();
-extern int DrawCommandsLength;
-typedef float float32;
+extern int CanvasBatchCapacity;
+extern int CanvasBatchCount;
+typedef struct {
+    GLuint Texture;
+    GLint First;
+    GLsizei Count;
+}CanvasBatch;
+extern CanvasBatch *CanvasBatches;
+extern int CanvasVertexCapacity;
+extern int CanvasVertexCount;
+extern CanvasVertex *CanvasVertices;
+extern Font DrawFont;
 typedef union {
     struct {
         float32 x;
@@ -31,22 +91,17 @@ typedef union {
     };
     float32 m[4];
 }V4;
-typedef struct {
-    GLuint Texture;
-    V4 Color;
-    size_t Length;
-    float32 *Data;
-}DrawCommand;
-#define DRAW_COMMANDS_COUNT 1024
-extern DrawCommand DrawCommands[DRAW_COMMANDS_COUNT];
-extern Font DrawFont;
 extern V4 DrawColor;
-extern GLuint CanvasColor;
+extern GLintptr CanvasOffset;
+extern GLuint CanvasStream;
+extern GLuint CanvasAttribColor;
+extern GLuint CanvasAttribUV;
+extern GLuint CanvasAttribXY;
 extern GLuint CanvasResolution;
-extern GLuint CanvasBuffer;
 extern GLuint CanvasVertexArray;
 extern GLuint CanvasProgram;
 extern GLuint WhiteTexture;
 #define INVALID -2 // invalid value for uniforms/attributes
 extern GLuint FontTexture;
+#define CanvasStreamSize (64 * 1024) // bytes of canvas vertices expected per frame
 #define INTERFACE 0
@@ -0,0 +1,261 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "collision.h"
+
+#if INTERFACE
+
+#define GridSize 16 // cells per axis over the wrapped [-1, 1] playfield
+#define GridCellCount (GridSize * GridSize)
+
+// uniform grid broadphase, each entity is listed in every cell its bounding
+// square overlaps so that a point query only has to look at a single cell
+typedef struct {
+    int CellStart[GridCellCount + 1]; // Items[CellStart[c]..CellStart[c + 1]] are in cell c
+    int Length;
+    int Capacity;
+    int *Items; // entity indices sorted by cell
+} Grid;
+
+#endif
+
+// distance from the model center to its farthest point
+float32 modelRadius(Model model) {
+    V2 center = (V2){model.Width / 2.0, model.Height / 2.0};
+    float32 radius = 0;
+    for (int k = 0; k < model.Length; k++) {
+        float32 length = V2Length(V2Subtract(model.Data[k], center));
+        if (length > radius) {
+            radius = length;
+        }
+    }
+    return radius;
+}
+
+// wrap a delta between two positions so it takes the short way around the playfield
+V2 wrapDelta(V2 delta) {
+    if (delta.x > 1) {
+        delta.x = delta.x - 2;
+    } else if (delta.x < -1) {
+        delta.x = delta.x + 2;
+    }
+
+    if (delta.y > 1) {
+        delta.y = delta.y - 2;
+    } else if (delta.y < -1) {
+        delta.y = delta.y + 2;
+    }
+    return delta;
+}
+
+int gridCoordinate(float32 x) {
+    int c = (int)floorf((x + 1) * (GridSize / 2.0f));
+    return ((c % GridSize) + GridSize) % GridSize;
+}
+
+int gridCell(V2 position) {
+    return gridCoordinate(position.y) * GridSize + gridCoordinate(position.x);
+}
+
+// size grid so that buildGrid() never has to grow it for count entities no
+// larger than radius
+void reserveGrid(Grid *grid, int count, float32 radius) {
+    int span = (int)(2 * radius * GridSize / 2.0f) + 2;
+    if (span > GridSize) {
+        span = GridSize;
+    }
+    if (count * span * span > grid->Capacity) {
+        grid->Capacity = count * span * span;
+        grid->Items = reallocate(grid->Items, grid->Capacity * sizeof(int));
+    }
+}
+
+// wrapped indices of the cells overlapping the box from min to max, returns
+// the number of cells written, at most GridCellCount
+int gridCellsInBox(V2 min, V2 max, int *cells) {
+    float32 cellsPerUnit = GridSize / 2.0f;
+    int x0 = (int)floorf((min.x + 1) * cellsPerUnit);
+    int x1 = (int)floorf((max.x + 1) * cellsPerUnit);
+    int y0 = (int)floorf((min.y + 1) * cellsPerUnit);
+    int y1 = (int)floorf((max.y + 1) * cellsPerUnit);
+    if (x1 - x0 >= GridSize) {
+        x1 = x0 + GridSize - 1;
+    }
+    if (y1 - y0 >= GridSize) {
+        y1 = y0 + GridSize - 1;
+    }
+
+    int count = 0;
+    for (int y = y0; y <= y1; y++) {
+        int row = ((y % GridSize) + GridSize) % GridSize * GridSize;
+        for (int x = x0; x <= x1; x++) {
+            cells[count] = row + ((x % GridSize) + GridSize) % GridSize;
+            count++;
+        }
+    }
+    return count;
+}
+
+// rebuild the grid with a counting sort over the cells, linear in the number
+// of active entities and the cells they cover
+void buildGrid(Grid *grid, EntityPool *pool) {
+    int *cellStart = grid->CellStart;
+    for (int c = 0; c <= GridCellCount; c++) {
+        cellStart[c] = 0;
+    }
+
+    // first pass counts how many entities land in each cell, offset by one so
+    // that the prefix sum below produces the start of each cell
+    int cells[GridCellCount];
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < pool->Count; i++) {
+            if (!pool->Active[i]) {
+                continue;
+            }
+
+            V2 position = pool->Position[i];
+            float32 radius = entityRadius(pool, i);
+            V2 min = V2SubtractScalar(position, radius);
+            V2 max = V2AddScalar(position, radius);
+            int cellCount = gridCellsInBox(min, max, cells);
+            for (int c = 0; c < cellCount; c++) {
+                if (pass == 0) {
+                    cellStart[cells[c] + 1]++;
+                } else {
+                    grid->Items[cellStart[cells[c]]] = i;
+                    cellStart[cells[c]]++;
+                }
+            }
+        }
+
+        if (pass == 0) {
+            for (int c = 0; c < GridCellCount; c++) {
+                cellStart[c + 1] += cellStart[c];
+            }
+            grid->Length = cellStart[GridCellCount];
+            if (grid->Length > grid->Capacity) {
+                grid->Capacity = grid->Length * 2;
+                grid->Items = reallocate(grid->Items, grid->Capacity * sizeof(int));
+            }
+        }
+    }
+
+    // the second pass advanced each start to the end of its cell, shift back
+    for (int c = GridCellCount; c > 0; c--) {
+        cellStart[c] = cellStart[c - 1];
+    }
+    cellStart[0] = 0;
+}
+
+// transformed points of the entity model, computed at most once per tick
+V2 *entityPolygon(Game *game, EntityPool *pool, int index) {
+    Model model = pool->Model[index];
+    if (model.Length > pool->PolygonStride) {
+        fatal("model with %d points does not fit the polygon cache", model.Length);
+    }
+
+    V2 *points = &pool->Polygon[index * pool->PolygonStride];
+    if (pool->PolygonTick[index] == game->Tick) {
+        game->PolygonCacheHits++;
+        return points;
+    }
+
+    game->PolygonCacheMisses++;
+    M3 transform = pool->Transform[index];
+    for (int k = 0; k < model.Length; k++) {
+        points[k] = M3MultiplyV2(transform, model.Data[k]);
+    }
+    pool->PolygonTick[index] = game->Tick;
+    return points;
+}
+
+// crossing number test against a polygon stored as pairs of line endpoints
+bool insidePolygon(V2 center, V2 *points, int length) {
+    bool inside = false;
+    for (int k = 0; k < length; k += 2) {
+        V2 p1 = points[k];
+        V2 p2 = points[k + 1];
+        if ((p1.y > center.y) != (p2.y > center.y) && (center.x < (p2.x - p1.x) * (center.y - p1.y) / (p2.y - p1.y) + p1.x)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+bool collision(Game *game, V2 center, EntityPool *pool, int index) {
+    // use the image of center nearest the entity so polygons that straddle an
+    // edge of the playfield still collide
+    V2 position = pool->Position[index];
+    V2 delta = wrapDelta(V2Subtract(center, position));
+
+    float32 radius = entityRadius(pool, index);
+    if (V2DotProduct(delta, delta) > radius * radius) {
+        game->BoundingCircleRejects++;
+        return false;
+    }
+
+    // project into the same space as the transformed points
+    center = M3MultiplyV2(game->Projection, V2Add(position, delta));
+
+    Model model = pool->Model[index];
+    return insidePolygon(center, entityPolygon(game, pool, index), model.Length);
+}
+
+// z component of the cross product of two 2D vectors
+float32 perpDot(V2 vl, V2 vr) {
+    return vl.x * vr.y - vl.y * vr.x;
+}
+
+// fraction along the segment from start to end at which it first touches the
+// entity polygon, 0 if the segment lies entirely inside, -1 if it misses
+float32 sweptCollision(Game *game, V2 start, V2 end, EntityPool *pool, int index) {
+    V2 position = pool->Position[index];
+    V2 motion = V2Subtract(end, start);
+    start = V2Add(position, wrapDelta(V2Subtract(start, position)));
+    end = V2Add(start, motion);
+
+    // reject if the closest point of the segment is outside the bounding circle
+    float32 radius = entityRadius(pool, index);
+    float32 lengthSquared = V2DotProduct(motion, motion);
+    float32 closest = 0;
+    if (lengthSquared > 0) {
+        closest = fminf(fmaxf(V2DotProduct(V2Subtract(position, start), motion) / lengthSquared, 0), 1);
+    }
+    V2 offset = V2Subtract(V2Add(start, V2MultiplyScalar(motion, closest)), position);
+    if (V2DotProduct(offset, offset) > radius * radius) {
+        game->BoundingCircleRejects++;
+        return -1;
+    }
+
+    start = M3MultiplyV2(game->Projection, start);
+    end = M3MultiplyV2(game->Projection, end);
+    V2 r = V2Subtract(end, start);
+
+    Model model = pool->Model[index];
+    V2 *points = entityPolygon(game, pool, index);
+
+    float32 first = -1;
+    for (int k = 0; k < model.Length; k += 2) {
+        V2 p1 = points[k];
+        V2 q = V2Subtract(points[k + 1], p1);
+        float32 denominator = perpDot(r, q);
+        if (denominator == 0) {
+            continue;
+        }
+
+        V2 d = V2Subtract(p1, start);
+        float32 u = perpDot(d, q) / denominator; // along the segment
+        float32 v = perpDot(d, r) / denominator; // along the edge
+        if (u >= 0 && u <= 1 && v >= 0 && v <= 1 && (first < 0 || u < first)) {
+            first = u;
+        }
+    }
+
+    if (first < 0 && insidePolygon(end, points, model.Length)) {
+        first = 0;
+    }
+    return first;
+}
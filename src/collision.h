@@ -0,0 +1,132 @@
+/* This file was automatically generated.  Do not edit! */
+typedef float float32;
+typedef union {
+    struct {
+        float32 x;
+        float32 y;
+    };
+    float32 m[2];
+}V2;
+V2 V2MultiplyScalar(V2 v,float32 s);
+typedef uint8_t uint8;
+typedef size_t memory_index;
+typedef struct {
+    uint8 *Base;
+    memory_index Size;
+    memory_index Used;
+}Arena;
+typedef struct {
+    float32 m[9];
+}M3;
+typedef double float64;
+typedef struct {
+    int Width;
+    int Height;
+    int Length;
+    V2 *Data;
+}Model;
+typedef uint64_t uint64;
+#define MaxTextLength 8 // characters in a text entity, including the terminator
+typedef struct {
+    int Count;
+    int FreeCount;
+    int *Free; // stack of inactive indices, spawnEntity pops and despawnEntity pushes
+    bool *Active;
+    V2 *Position;
+    V2 *Velocity;
+    float32 *Rotation;
+    V2 *PreviousPosition; // at the start of the last tick, for render interpolation
+    float32 *PreviousRotation;
+    float32 *RotationSpeed;
+    M3 *Transform;
+    float32 *Intensity;
+    float64 *Created;
+    Model *Model;
+    int *AsteroidSize;
+    float32 *Radius; // model space bounding radius around the model center
+
+    // per tick cache of the collision polygon, only allocated for pools that
+    // are tested with collision()
+    int PolygonStride;
+    uint64 *PolygonTick;
+    V2 *Polygon;
+
+    // only for the text pool, the string each entity shows, its Model only
+    // has the size
+    char (*Text)[MaxTextLength];
+}EntityPool;
+#define GridSize 16 // cells per axis over the wrapped [-1, 1] playfield
+#define GridCellCount (GridSize * GridSize)
+typedef struct {
+    int CellStart[GridCellCount + 1]; // Items[CellStart[c]..CellStart[c + 1]] are in cell c
+    int Length;
+    int Capacity;
+    int *Items; // entity indices sorted by cell
+}Grid;
+typedef uint32_t uint32;
+typedef struct {
+    uint32 Words[4];
+}Random;
+#define RandomLaneCount 8
+typedef struct {
+    uint32 Words[4][RandomLaneCount];
+}RandomLanes;
+typedef struct {
+    bool RotateLeft;
+    bool RotateRight;
+    bool Fire;
+    bool Accelerate;
+}GameInput;
+typedef struct {
+    Arena Memory; // backs every EntityPool
+    EntityPool Asteroids;
+    EntityPool Bullets;
+    EntityPool Ship;
+    EntityPool ExplosionParticles;
+    EntityPool Texts;
+    Grid AsteroidGrid;
+    int ScoreText;  // index into Texts
+    int ShownScore; // the score ScoreText shows
+    M3 Projection;
+
+    Random Random;
+    RandomLanes ParticleRandom; // for bulk draws when spawning particles
+
+    GameInput Input;
+    int Score;
+    int Wave;
+    float64 Time;
+    float64 TickDuration;
+    float64 Accumulator; // time passed to advanceSimulation() not yet simulated
+    float64 LastBulletTime;
+    uint64 Tick; // number of update() calls, starts at 1 so that 0 is never current
+
+    // counters for checking the effectiveness of the polygon cache and
+    // bounding circle rejection under load
+    int PolygonCacheHits;
+    int PolygonCacheMisses;
+    int BoundingCircleRejects;
+}Game;
+float32 sweptCollision(Game *game,V2 start,V2 end,EntityPool *pool,int index);
+float32 perpDot(V2 vl,V2 vr);
+V2 V2Add(V2 vl,V2 vr);
+float32 V2DotProduct(V2 vl,V2 vr);
+bool collision(Game *game,V2 center,EntityPool *pool,int index);
+bool insidePolygon(V2 center,V2 *points,int length);
+V2 M3MultiplyV2(M3 ml,V2 vr);
+void fatal(const char *fmt,...);
+V2 *entityPolygon(Game *game,EntityPool *pool,int index);
+V2 V2AddScalar(V2 v,float32 s);
+V2 V2SubtractScalar(V2 v,float32 s);
+float32 entityRadius(EntityPool *pool,int index);
+void buildGrid(Grid *grid,EntityPool *pool);
+int gridCellsInBox(V2 min,V2 max,int *cells);
+void *reallocate(void *memory,size_t size);
+void reserveGrid(Grid *grid,int count,float32 radius);
+int gridCell(V2 position);
+int gridCoordinate(float32 x);
+V2 wrapDelta(V2 delta);
+V2 V2Subtract(V2 vl,V2 vr);
+float32 V2Length(V2 v);
+float32 modelRadius(Model model);
+#define INTERFACE 0
@@ -1,9 +1,14 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <stdatomic.h>
 
 #include "common.h"
 
+// general heap allocations made through allocate() and reallocate(), in DEBUG
+// builds frame() checks that a steady-state frame adds none
+atomic_int HeapAllocations;
+
 void fatal(const char *fmt, ...) {
     printf("fatal: ");
     va_list args;
@@ -11,4 +16,30 @@ void fatal(const char *fmt, ...) {
     vprintf(fmt, args);
     va_end(args);
     exit(EXIT_FAILURE);
-}
\ No newline at end of file
+}
+
+int heapAllocations() {
+    return atomic_load_explicit(&HeapAllocations, memory_order_relaxed);
+}
+
+void *allocate(size_t size) {
+#ifdef DEBUG
+    atomic_fetch_add_explicit(&HeapAllocations, 1, memory_order_relaxed);
+#endif
+    void *memory = malloc(size);
+    if (memory == NULL && size > 0) {
+        fatal("failed to allocate %zu bytes", size);
+    }
+    return memory;
+}
+
+void *reallocate(void *memory, size_t size) {
+#ifdef DEBUG
+    atomic_fetch_add_explicit(&HeapAllocations, 1, memory_order_relaxed);
+#endif
+    memory = realloc(memory, size);
+    if (memory == NULL && size > 0) {
+        fatal("failed to allocate %zu bytes", size);
+    }
+    return memory;
+}
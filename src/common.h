@@ -1,2 +1,6 @@
 /* This file was automatically generated.  Do not edit! */
+void *reallocate(void *memory,size_t size);
+void *allocate(size_t size);
+int heapAllocations();
 void fatal(const char *fmt,...);
+extern atomic_int HeapAllocations;
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <math.h>
 #include <time.h>
 #include <stdlib.h>
@@ -17,41 +18,68 @@
 
 #if INTERFACE
 
-#define AsteroidCount 128
-#define BulletCount 3
-#define TextCount 16
-#define ExplosionParticleCount 256
-#define EntityCount 1 + AsteroidCount + BulletCount + TextCount + ExplosionParticleCount
-
-#define BulletExpiration 1.0
-#define ExplosionParticleExpiration 1.0
-#define BulletInterval 0.2
-
-#define AsteroidIntensity 0.2
-#define BulletIntensity 10.0
-#define ShipIntensity 0.2
-#define ScoreIntensity 0.2
-
 #define DecayConstant 0.5f // higher = longer trails
 
+#define SegmentTextureWidth 256
+#define MaxSegmentRanges 16
+#define MaxGlyphs 128
+#define FrameArenaSize (4 * 1024 * 1024)
+#define WarmupFrames 2 // frames allowed to allocate before the DEBUG heap check
+
+// the frame targets are rendered at RenderScale of the screen's size and
+// stretched over it by the blend, the scale is stepped between
+// MinRenderScale and 1 by updateRenderScale()
+#define MinRenderScale 0.5f
+#define RenderScaleStep 0.125f
+#define ScaleDownLoad 0.85 // of the frame interval, GPU time above this lowers the scale
+#define ScaleUpLoad 0.6    // and below this raises it, the gap between them keeps it from flipping
+#define DroppingLoad 1.1   // without GPU timers, a mean frame time this far past the interval
+#define SteadyLoad 1.02    // and this close to it
+#define ScaleSettleFrames 30    // a load has to hold this long before the scale changes, longer than GPUTimerLatency
+#define ScaleUpSettleFrames 240 // without GPU timers a higher scale is only tried after this long steady
+#define FrameIntervalWindow 60  // frames, see updateRenderScale()
+
+// per entity data streamed to line.vsh, so that all entities sharing a model
+// are drawn with a single instanced call
 typedef struct {
-    bool Active;
-    V2 Position;
-    V2 Velocity;
+    M3 Transform;
+    V2 Offset; // jitter in model space
     float32 Intensity;
-    float32 Rotation;      // radians
-    float32 RotationSpeed; // radians per second
-    GLuint VBO;
-    GLuint VAO;
+    int32 FirstSegment; // in SegmentTexture
+    int32 SegmentCount; // segments beyond this are not drawn
+} LineInstance;
+
+// a run of LineInstances drawn with the same model
+typedef struct {
+    const V2 *Model;
+    int FirstSegment; // in SegmentTexture
+    int VertexCount;
+    int First;
+    int Count;
+} LineBatch;
+
+// where the segments of a model are stored in SegmentTexture
+typedef struct {
     Model Model;
-    float64 Created;
-    M3 Transform;
-    int AsteroidSize;
-} Entity;
+    int First;
+} SegmentRange;
+
+#define MaxBlurTaps 8 // MAX_TAPS in blur.fsh
 
-#define AsteroidSizeSmall 1
-#define AsteroidSizeMedium 2
-#define AsteroidSizeLarge 3
+typedef enum {
+    BlurLow,
+    BlurMedium,
+    BlurHigh,
+    BlurQualityCount,
+} BlurQualityTier;
+
+// a Gaussian blur of the bloom, run in alternating directions starting with
+// vertical
+typedef struct {
+    int Radius; // texels each side, at most (MaxBlurTaps - 1) * 2
+    float32 Sigma;
+    int Passes;
+} BlurQuality;
 
 #endif
 
@@ -61,73 +89,100 @@ extern int ScreenWidth;
 extern int ScreenHeight;
 
 float LineWidthPixels;
-int Score;
 
-GLuint CurrentTexture = INVALID;
-GLuint CurrentFramebuffer = INVALID;
-GLuint PreviousTexture = INVALID;
-GLuint PreviousFramebuffer = INVALID;
+// the targets kept across frames, from the pool in target.c and sized for
+// TargetWidth by TargetHeight, the others are acquired within a frame
+RenderTarget *CurrentTarget;
+RenderTarget *PreviousTarget; // the last frame, decayed into the current one
+int TargetWidth;
+int TargetHeight;
+
+// the sim's projection keeps the aspect ratio from setup, entities are drawn
+// with one for the current screen so that a resized window isn't stretched
+M3 RenderProjection;
+
+float32 RenderScale = 1;
+float64 FrameInterval;   // of the display, the shortest recent time between frames
+float64 WindowInterval;  // shortest in the window being filled
+float64 LastWindowInterval;
+int WindowFrames;
+float64 MeanFrameTime;   // moving average of the time between frames
+int OverBudgetFrames;    // in a row
+int UnderBudgetFrames;
+
+RenderGraph FrameGraph;
 
 GLuint ThresholdProgram = INVALID;
 GLuint ThresholdVertexArray = INVALID;
 
-GLuint HalfTexture = INVALID;
-GLuint HalfFramebuffer = INVALID;
-GLuint QuarterTexture = INVALID;
-GLuint QuarterFramebuffer = INVALID;
-
 GLuint DecayProgram = INVALID;
 GLuint DecayVertexArray = INVALID;
 GLuint DecayUniformDecay = INVALID;
 
 GLuint BlurProgram = INVALID;
 GLuint BlurHorizontal = INVALID;
+GLuint BlurUniformTapCount = INVALID;
+GLuint BlurUniformOffsets = INVALID;
+GLuint BlurUniformWeights = INVALID;
 GLuint BlurVertexArray = INVALID;
-GLuint BlurTextureA = INVALID;
-GLuint BlurFramebufferA = INVALID;
-GLuint BlurTextureB = INVALID;
-GLuint BlurFramebufferB = INVALID;
+
+// Medium is the original bloom, a sigma 2 kernel of 9 texels run three times
+BlurQuality BlurQualities[] = {
+    [BlurLow] = {.Radius = 4, .Sigma = 2, .Passes = 2},
+    [BlurMedium] = {.Radius = 4, .Sigma = 2, .Passes = 3},
+    [BlurHigh] = {.Radius = 8, .Sigma = 4, .Passes = 3},
+};
+int BlurTier = BlurMedium;
 
 GLuint BlendProgram = INVALID;
 GLuint BlendVertexArray = INVALID;
-GLuint BlendTexture = INVALID;
-GLuint BlendFramebuffer = INVALID;
 GLuint BlendUniformOriginal = INVALID;
 GLuint BlendUniformBloom = INVALID;
 
 GLuint LineProgram = INVALID;
-GLuint LineUniformTransform = INVALID;
+GLuint LineVertexArray = INVALID;
 GLuint LineUniformResolution = INVALID;
 GLuint LineUniformWidth = INVALID;
-GLuint LineUniformIntensity = INVALID;
-GLuint LineUniformOffset = INVALID;
-
-GLuint CopyProgram = INVALID;
-GLuint CopyVertexArray = INVALID;
+GLuint LineUniformSegments = INVALID;
+GLuint LineAttribTransform = INVALID; // mat3, takes three locations
+GLuint LineAttribOffset = INVALID;
+GLuint LineAttribIntensity = INVALID;
+GLuint LineAttribSegments = INVALID;
+
+// every per frame vertex stream is sub-allocated from FrameStream, mapped
+// once at the start of each frame
+StreamBuffer FrameStream;
+
+// memory that lives until the end of the frame, reset at its start
+Arena FrameArena;
+uint64 FrameCount;
+
+// instances of the frame being drawn, written straight into FrameStream
+LineInstance *LineInstances;
+GLintptr LineInstanceOffset; // from FrameStream.Base
+int LineInstanceCount;
+LineBatch *LineBatches; // sized at setup for every pool entry
+int LineBatchCount;
+int EntityDrawCalls; // in the last frame
+
+// every model's line segments stored once, one RGBA32F texel holding the two
+// endpoints of each, and fetched by line.vsh from gl_VertexID
+GLuint SegmentTexture;
+int SegmentCapacity;
+SegmentRange SegmentRanges[MaxSegmentRanges];
+int SegmentRangeCount;
+// every BattleFont glyph end to end in one range, so that text is drawn as
+// glyph instances in a single batch however much of it there is
+Model GlyphModel;
+int GlyphRange;
+int GlyphFirstSegment[MaxGlyphs]; // from the start of GlyphRange
+int GlyphSegmentCount[MaxGlyphs];
+int MaxGlyphSegmentCount;
 
 GLuint CubeVertexArray = INVALID;
 
 uint8 ImageBuffer[2048 * 2048 * 4];
 
-Entity Entities[EntityCount];
-Entity *Asteroids;
-Entity *Bullets;
-Entity *Ship;
-Entity *ExplosionParticles;
-Entity *Texts;
-Entity *ScoreText;
-
-GLuint VAOBullet;
-GLuint VAOShip;
-GLuint VAOAsteroid1;
-GLuint VAOAsteroid2;
-GLuint VAOAsteroid3;
-GLuint VAOAsteroid4;
-
-M3 Projection;
-
-#define Scale 0.001
-
 float32 QuadData[] = {
     -1.0f, -1.0f,
     1.0f, -1.0f,
@@ -141,38 +196,111 @@ float32 QuadData[] = {
 #define KEY_A 2
 #define KEY_D 0
 #define KEY_P 35
+#define KEY_T 17
+#define KEY_G 5
+#define KEY_L 37
+#define KEY_R 15
+#define KEY_B 11
 #define KEY_SPACE 49
 
-bool InputRotateLeft;
-bool InputRotateRight;
-bool InputFire;
-bool InputAccelerate;
+Game State; // the game being played and drawn
+Random EffectRandom; // for effects that don't change the game, like line jitter
+float32 TickFraction; // how far the frame is between the last two ticks
 
 bool PauseMode;
-float64 Time;
+bool ShowGPUTimes; // the per pass GPU time table and the frame stats over the frame
 float64 DeltaTime;
 float64 LastTimestamp;
 
-float64 LastBulletTime;
-
 void keyboardInput(int code, bool down) {
     if (code == KEY_SPACE) {
-        InputFire = down;
+        State.Input.Fire = down;
     } else if (code == KEY_W) {
-        InputAccelerate = down;
+        State.Input.Accelerate = down;
     } else if (code == KEY_A) {
-        InputRotateLeft = down;
+        State.Input.RotateLeft = down;
     } else if (code == KEY_D) {
-        InputRotateRight = down;
+        State.Input.RotateRight = down;
     } else if (code == KEY_P) {
         if (down) {
             PauseMode = !PauseMode;
         }
+    } else if (code == KEY_G) {
+        if (down) {
+            ShowGPUTimes = !ShowGPUTimes;
+        }
+    } else if (code == KEY_L) {
+        if (down) {
+            logGPUTimes();
+        }
+    } else if (code == KEY_R) {
+        if (down) {
+            toggleProfiler();
+        }
+    } else if (code == KEY_B) {
+        if (down) {
+            setBlurQuality((BlurTier + 1) % BlurQualityCount);
+            printf("blur quality %d\n", BlurTier);
+        }
+#if defined(DEBUG)
+    } else if (code == KEY_T) {
+        if (down) {
+            sweptCollisionScene(&State);
+        }
+#endif
     } else {
         printf("keyboardInput code=%d\n", code);
     }
 }
 
+// write the GPU time table next to the app's other temporary files
+void logGPUTimes() {
+    char *directory = getenv("TMPDIR");
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/gpu-times.txt", directory != NULL ? directory : "/tmp");
+    if (dumpGPUTimes(path)) {
+        printf("gpu times written to %s\n", path);
+    } else {
+        printf("failed to write gpu times to %s\n", path);
+    }
+}
+
+// counts of the last frame, drawn under the GPU time table
+void drawFrameStats(int x, int y) {
+    char lines[6][64];
+    int count = 0;
+    snprintf(lines[count++], sizeof(lines[0]), "%-20s %6d", "entity draws", EntityDrawCalls);
+    snprintf(lines[count++], sizeof(lines[0]), "%-20s %6.1f", "stream kb", FrameStream.FrameBytes / 1024.0);
+    snprintf(lines[count++], sizeof(lines[0]), "%-20s %6.1f", "stream kb avg",
+             FrameCount > 0 ? FrameStream.TotalBytes / 1024.0 / FrameCount : 0);
+    snprintf(lines[count++], sizeof(lines[0]), "%-20s %6d", "stream stalls", FrameStream.Stalls);
+    snprintf(lines[count++], sizeof(lines[0]), "%-20s %6d", "gl state issued", GLState.FrameIssued);
+    snprintf(lines[count++], sizeof(lines[0]), "%-20s %6d", "gl state skipped", GLState.FrameSkipped);
+    for (int i = 0; i < count; i++) {
+        y -= DrawFont.Height;
+        drawText(lines[i], x, y);
+    }
+}
+
+// start recording CPU spans, or stop and write them out as a Chrome trace
+void toggleProfiler() {
+    if (!profilerEnabled()) {
+        enableProfiler(true);
+        printf("profiler recording\n");
+        return;
+    }
+
+    enableProfiler(false);
+    char *directory = getenv("TMPDIR");
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/trace.json", directory != NULL ? directory : "/tmp");
+    if (writeChromeTrace(path)) {
+        printf("trace written to %s\n", path);
+    } else {
+        printf("failed to write trace to %s\n", path);
+    }
+}
+
 void touchInput(float x, float y) {
     //    if (Rotate) {
     //        RotateClockwise = !RotateClockwise;
@@ -180,93 +308,270 @@ void touchInput(float x, float y) {
     //    Rotate = !Rotate;
 }
 
-void generateTextureFramebuffer(GLuint *texture, GLuint *framebuffer, int scale, char *name) {
-    glGenFramebuffers(1, framebuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, *framebuffer);
-    glLabelObject(GL_FRAMEBUFFER, *framebuffer, name);
+// step RenderScale by how long the GPU took over the last frames read back,
+// or failing GPU timers by whether frames are being dropped, a load has to
+// hold for a while before the scale moves and the counts restart after it
+// does, so that it settles rather than following every slow frame
+void updateRenderScale(float64 deltaT) {
+    if (deltaT <= 0) {
+        return;
+    }
+    // the shortest time between frames over the last one to two windows, so
+    // that a short frame from jitter or a change of display is soon forgotten
+    if (WindowFrames == 0 || deltaT < WindowInterval) {
+        WindowInterval = deltaT;
+    }
+    FrameInterval = LastWindowInterval > 0 && LastWindowInterval < WindowInterval ? LastWindowInterval : WindowInterval;
+    if (++WindowFrames == FrameIntervalWindow) {
+        LastWindowInterval = WindowInterval;
+        WindowFrames = 0;
+    }
+    MeanFrameTime = MeanFrameTime == 0 ? deltaT : MeanFrameTime * 0.9 + deltaT * 0.1;
+
+    // vsync holds the time between frames at the interval however idle the
+    // GPU is, so without timers there is no headroom to see, only drops
+    bool over, under;
+    int upFrames;
+    if (GPUTimersAvailable) {
+        float64 load = GPUFrameTime * 1e-3 / FrameInterval;
+        over = load > ScaleDownLoad;
+        under = load < ScaleUpLoad;
+        upFrames = ScaleSettleFrames;
+    } else {
+        float64 load = MeanFrameTime / FrameInterval;
+        over = load > DroppingLoad;
+        under = load < SteadyLoad;
+        upFrames = ScaleUpSettleFrames;
+    }
+    OverBudgetFrames = over ? OverBudgetFrames + 1 : 0;
+    UnderBudgetFrames = under ? UnderBudgetFrames + 1 : 0;
+
+    float32 scale = RenderScale;
+    if (OverBudgetFrames >= ScaleSettleFrames) {
+        scale = fmaxf(RenderScale - RenderScaleStep, MinRenderScale);
+    } else if (UnderBudgetFrames >= upFrames) {
+        scale = fminf(RenderScale + RenderScaleStep, 1);
+    }
+    if (scale != RenderScale) {
+        RenderScale = scale;
+        OverBudgetFrames = 0;
+        UnderBudgetFrames = 0;
+        MeanFrameTime = FrameInterval;
+        printf("render scale %.3f\n", RenderScale);
+    }
+}
+
+// swap the targets kept across frames for ones of RenderScale of the
+// screen's size if that changed, -reshape only updates ScreenWidth and
+// ScreenHeight, the old targets go back to the pool and are deleted once they
+// age out
+void sizeRenderTargets() {
+    int width = (int)(ScreenWidth * RenderScale + 0.5f);
+    int height = (int)(ScreenHeight * RenderScale + 0.5f);
+    if (CurrentTarget != NULL && TargetWidth == width && TargetHeight == height) {
+        return;
+    }
+    RenderTarget *current = CurrentTarget;
+    RenderTarget *previous = PreviousTarget;
+
+    TargetWidth = width;
+    TargetHeight = height;
+    LineWidthPixels = height * 0.010;
+    RenderProjection = M3Scale(M3Identity, (V2){(float32)ScreenHeight / ScreenWidth, 1.0});
+
+    // linear so that the bloom's downsample averages every pixel and the
+    // blend stretches the frame smoothly over the screen
+    CurrentTarget = acquireRenderTarget(width, height, GL_RGBA8, GL_LINEAR, "Frame");
+    PreviousTarget = acquireRenderTarget(width, height, GL_RGBA8, GL_LINEAR, "Frame");
+    setFramebuffer(PreviousTarget->Framebuffer);
+
+    // the first frame starts without trails
+    if (previous == NULL) {
+        glClearColor(0, 0, 0, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glClearColor(1.0f, 0.078f, 0.58f, 1.0f);
+        return;
+    }
 
-    glGenTextures(1, texture);
-    glBindTexture(GL_TEXTURE_2D, *texture);
-    glLabelObject(GL_TEXTURE, *texture, name);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    // keep the trails, setFramebuffer() bound both, so the read binding is
+    // put back after
+    setScissor(false);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previous->Framebuffer);
+    glBlitFramebuffer(0, 0, previous->Width, previous->Height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, PreviousTarget->Framebuffer);
+    releaseRenderTarget(current);
+    releaseRenderTarget(previous);
+}
+
+// copy the segments of range into SegmentTexture a row at a time, consecutive
+// pairs of model points are already laid out as RGBA texels
+void uploadSegments(SegmentRange range) {
+    int count = range.Model.Length / 2;
+    int end = range.First + count;
+    setTexture(0, SegmentTexture);
+    for (int segment = range.First; segment < end;) {
+        int x = segment % SegmentTextureWidth;
+        int y = segment / SegmentTextureWidth;
+        int length = SegmentTextureWidth - x < end - segment ? SegmentTextureWidth - x : end - segment;
+        const V2 *data = &range.Model.Data[(segment - range.First) * 2];
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, length, 1, GL_RGBA, GL_FLOAT, data);
+        segment += length;
+    }
+}
+
+// make room for count segments, a larger texture is filled again from the
+// models of every range
+void reserveSegments(int count) {
+    if (count <= SegmentCapacity) {
+        return;
+    }
+
+    int rows = (count + SegmentTextureWidth - 1) / SegmentTextureWidth;
+    SegmentCapacity = rows * SegmentTextureWidth;
+    if (SegmentTexture != 0) {
+        deleteTexture(SegmentTexture);
+    }
+    glGenTextures(1, &SegmentTexture);
+    setTexture(0, SegmentTexture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, ScreenWidth / scale, ScreenHeight / scale, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, *texture, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, SegmentTextureWidth, rows, 0, GL_RGBA, GL_FLOAT, NULL);
 
-    checkFramebuffer();
+    for (int i = 0; i < SegmentRangeCount; i++) {
+        uploadSegments(SegmentRanges[i]);
+    }
 }
 
-Model createTextModel(char *text) {
-    int length = 0;
-    for (int i = 0; i < strlen(text); i++) {
-        Model charModel = BattleFont.Characters[text[i]];
-        length += charModel.Length;
+int addSegmentRange(Model model) {
+    if (SegmentRangeCount == MaxSegmentRanges) {
+        fatal("too many segment ranges");
     }
 
-    Model textModel = {
-        .Height = BattleFont.Height,
+    int first = 0;
+    if (SegmentRangeCount > 0) {
+        SegmentRange last = SegmentRanges[SegmentRangeCount - 1];
+        first = last.First + last.Model.Length / 2;
+    }
+    SegmentRanges[SegmentRangeCount] = (SegmentRange){
+        .Model = model,
+        .First = first,
     };
+    SegmentRangeCount++;
 
-    V2 *data = malloc(length * sizeof(V2));
-    for (int i = 0; i < strlen(text); i++) {
-        Model charModel = BattleFont.Characters[text[i]];
-        if (charModel.Data == NULL) {
-            continue;
+    reserveSegments(first + model.Length / 2);
+    uploadSegments(SegmentRanges[SegmentRangeCount - 1]);
+    return SegmentRangeCount - 1;
+}
+
+void addGlyphRange() {
+    if (BattleFont.Length > MaxGlyphs) {
+        fatal("font has %d glyphs, at most %d fit", BattleFont.Length, MaxGlyphs);
+    }
+
+    int length = 0;
+    for (int c = 0; c < BattleFont.Length; c++) {
+        length += BattleFont.Characters[c].Length;
+    }
+    V2 *points = allocate(length * sizeof(V2));
+
+    GlyphModel = (Model){
+        .Data = points,
+    };
+    for (int c = 0; c < BattleFont.Length; c++) {
+        Model glyph = BattleFont.Characters[c];
+        GlyphFirstSegment[c] = GlyphModel.Length / 2;
+        GlyphSegmentCount[c] = glyph.Data != NULL ? glyph.Length / 2 : 0;
+        if (GlyphSegmentCount[c] > MaxGlyphSegmentCount) {
+            MaxGlyphSegmentCount = GlyphSegmentCount[c];
         }
-        for (int j = 0; j < charModel.Length; j++) {
-            V2 point = charModel.Data[j];
-            M3 transform = M3Identity;
-            transform = M3Translate(transform, (V2){textModel.Width, textModel.Height});
-            data[textModel.Length] = M3MultiplyV2(transform, point);
-            textModel.Length++;
+        if (GlyphSegmentCount[c] > 0) {
+            memcpy(&points[GlyphModel.Length], glyph.Data, GlyphSegmentCount[c] * 2 * sizeof(V2));
+            GlyphModel.Length += GlyphSegmentCount[c] * 2;
         }
-        textModel.Width += charModel.Width;
     }
-    textModel.Data = data;
-    return textModel;
+    GlyphRange = addSegmentRange(GlyphModel);
 }
 
-GLuint createModelBuffer(Model m) {
-    V2 data[m.Length * 6];
-    for (int i = 0; i < m.Length; i += 2) {
-        for (int j = 0; j < 6; j++) {
-            data[i * 6 + j * 2] = m.Data[i];
-            data[i * 6 + j * 2 + 1] = m.Data[i + 1];
+// glyphs in a text that have segments to draw
+int glyphCount(const char *text) {
+    int count = 0;
+    for (int i = 0; text[i] != '\0'; i++) {
+        count += GlyphSegmentCount[text[i]] > 0;
+    }
+    return count;
+}
+
+// the simulation knows nothing about GL, so entities are matched to their
+// segments by model, -1 if there is nothing to draw
+int segmentRange(Model model) {
+    for (int i = 0; i < SegmentRangeCount; i++) {
+        if (SegmentRanges[i].Model.Data == model.Data) {
+            return SegmentRanges[i].Model.Length > 0 ? i : -1;
         }
     }
+    return -1;
+}
+
+// point the per instance attributes of the bound VAO at instance first of
+// the frame's instances, GL ES 3.0 has no draw call with a base instance
+void pointLineInstances(int first) {
+    GLsizei stride = sizeof(LineInstance);
+    size_t base = FrameStream.Base + LineInstanceOffset + first * sizeof(LineInstance);
 
-    GLuint buffer;
-    glGenBuffers(1, &buffer);
-    glBindBuffer(GL_ARRAY_BUFFER, buffer);
-    glBufferData(GL_ARRAY_BUFFER, m.Length * 6 * sizeof(V2), data, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, FrameStream.Buffer);
+    for (int column = 0; column < 3; column++) {
+        size_t offset = base + offsetof(LineInstance, Transform) + column * 3 * sizeof(float32);
+        glVertexAttribPointer(LineAttribTransform + column, 3, GL_FLOAT, GL_FALSE, stride, BUFFER_OFFSET(offset));
+    }
+    glVertexAttribPointer(LineAttribOffset, 2, GL_FLOAT, GL_FALSE, stride, BUFFER_OFFSET(base + offsetof(LineInstance, Offset)));
+    glVertexAttribPointer(LineAttribIntensity, 1, GL_FLOAT, GL_FALSE, stride, BUFFER_OFFSET(base + offsetof(LineInstance, Intensity)));
+    glVertexAttribIPointer(LineAttribSegments, 2, GL_INT, stride, BUFFER_OFFSET(base + offsetof(LineInstance, FirstSegment)));
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    return buffer;
 }
 
-GLuint createModelVAO(GLuint buffer) {
-    GLuint vao;
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
-
-    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+// one side of the kernel of quality as bilinear taps, returns the tap count,
+// texel weights are the Gaussian integrated over each texel, then each pair of
+// texels after the center becomes one tap placed between them by weight
+int blurKernel(BlurQuality quality, float32 *offsets, float32 *weights) {
+    float64 texels[MaxBlurTaps * 2];
+    float64 total = 0;
+    for (int i = 0; i <= quality.Radius; i++) {
+        float64 scale = 1 / (quality.Sigma * M_SQRT2);
+        texels[i] = (erf((i + 0.5) * scale) - erf((i - 0.5) * scale)) / 2;
+        total += i == 0 ? texels[i] : texels[i] * 2;
+    }
 
-    GLuint attribStart = glGetAttribLocation(LineProgram, "start");
-    GLuint attribEnd = glGetAttribLocation(LineProgram, "end");
-    glEnableVertexAttribArray(attribStart);
-    glEnableVertexAttribArray(attribEnd);
-    glVertexAttribPointer(attribStart, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), BUFFER_OFFSET(0));
-    glVertexAttribPointer(attribEnd, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), BUFFER_OFFSET(2 * sizeof(float)));
+    offsets[0] = 0;
+    weights[0] = texels[0] / total;
+    int taps = 1;
+    for (int i = 1; i <= quality.Radius; i += 2) {
+        float64 a = texels[i];
+        float64 b = i + 1 <= quality.Radius ? texels[i + 1] : 0;
+        offsets[taps] = (i * a + (i + 1) * b) / (a + b);
+        weights[taps] = (a + b) / total;
+        taps++;
+    }
+    return taps;
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-    return vao;
+void setBlurQuality(int tier) {
+    if (BlurQualities[tier].Radius > (MaxBlurTaps - 1) * 2) {
+        fatal("blur radius %d needs more than %d taps", BlurQualities[tier].Radius, MaxBlurTaps);
+    }
+    float32 offsets[MaxBlurTaps];
+    float32 weights[MaxBlurTaps];
+    int taps = blurKernel(BlurQualities[tier], offsets, weights);
+
+    BlurTier = tier;
+    setProgram(BlurProgram);
+    glUniform1i(BlurUniformTapCount, taps);
+    glUniform1fv(BlurUniformOffsets, taps, offsets);
+    glUniform1fv(BlurUniformWeights, taps, weights);
 }
 
 void setupFullscreenQuad(GLuint program, GLuint *array) {
     glGenVertexArrays(1, array);
-    glBindVertexArray(*array);
+    setVertexArray(*array);
 
     {
         GLuint arrayBuffer;
@@ -278,42 +583,17 @@ void setupFullscreenQuad(GLuint program, GLuint *array) {
         glEnableVertexAttribArray(position);
         glVertexAttribPointer(position, 2, GL_FLOAT, GL_FALSE, 0, BUFFER_OFFSET(0));
     }
-
-    glBindVertexArray(0);
 }
 
 void setup() {
-    srand((unsigned)time(NULL));
-
-    LineWidthPixels = ScreenHeight * 0.010;
-
-    glViewport(0, 0, ScreenWidth, ScreenHeight);
-    glActiveTexture(GL_TEXTURE0);
+    // the platform code may have changed anything before setup
+    invalidateGLState();
+    setViewport(0, 0, ScreenWidth, ScreenHeight);
 
     setupCanvas();
+    setupGPUTimers();
 
-    generateTextureFramebuffer(&CurrentTexture, &CurrentFramebuffer, 1, "FrameA");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-
-    generateTextureFramebuffer(&PreviousTexture, &PreviousFramebuffer, 1, "FrameB");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-
-    glClearColor(0, 0, 0, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
-
-    generateTextureFramebuffer(&HalfTexture, &HalfFramebuffer, 2, "Half");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    generateTextureFramebuffer(&QuarterTexture, &QuarterFramebuffer, 4, "Quarter");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-
-    generateTextureFramebuffer(&BlurTextureA, &BlurFramebufferA, 8, "BlurA");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    generateTextureFramebuffer(&BlurTextureB, &BlurFramebufferB, 8, "BlurB");
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    generateTextureFramebuffer(&BlendTexture, &BlendFramebuffer, 1, "Blend");
-
-    glClearColor(1.0f, 0.078f, 0.58f, 1.0f);
+    sizeRenderTargets();
 
     DecayProgram = compileProgram(DecayVertexSource, DecayFragmentSource, "Decay");
     DecayUniformDecay = glGetUniformLocation(DecayProgram, "decay");
@@ -324,485 +604,391 @@ void setup() {
 
     BlurProgram = compileProgram(BlurVertexSource, BlurFragmentSource, "Blur");
     BlurHorizontal = glGetUniformLocation(BlurProgram, "horizontal");
+    BlurUniformTapCount = glGetUniformLocation(BlurProgram, "tapCount");
+    BlurUniformOffsets = glGetUniformLocation(BlurProgram, "offsets");
+    BlurUniformWeights = glGetUniformLocation(BlurProgram, "weights");
     setupFullscreenQuad(BlurProgram, &BlurVertexArray);
+    setBlurQuality(BlurTier);
 
     BlendProgram = compileProgram(BlendVertexSource, BlendFragmentSource, "Blend");
     setupFullscreenQuad(BlendProgram, &BlendVertexArray);
     BlendUniformOriginal = glGetUniformLocation(BlendProgram, "original");
     BlendUniformBloom = glGetUniformLocation(BlendProgram, "bloom");
 
-    CopyProgram = compileProgram(CopyVertexSource, CopyFragmentSource, "Copy");
-    setupFullscreenQuad(CopyProgram, &CopyVertexArray);
-
     LineProgram = compileProgram(LineVertexSource, LineFragmentSource, "Line");
-    LineUniformTransform = glGetUniformLocation(LineProgram, "transform");
     LineUniformResolution = glGetUniformLocation(LineProgram, "resolution");
-    LineUniformTransform = glGetUniformLocation(LineProgram, "transform");
     LineUniformWidth = glGetUniformLocation(LineProgram, "width");
-    LineUniformIntensity = glGetUniformLocation(LineProgram, "intensity");
-    LineUniformOffset = glGetUniformLocation(LineProgram, "offset");
-
-    VAOBullet = createModelVAO(createModelBuffer(ModelBullet));
-    VAOShip = createModelVAO(createModelBuffer(ModelShip));
-    VAOAsteroid1 = createModelVAO(createModelBuffer(ModelAsteroid1));
-    VAOAsteroid2 = createModelVAO(createModelBuffer(ModelAsteroid2));
-    VAOAsteroid3 = createModelVAO(createModelBuffer(ModelAsteroid3));
-    VAOAsteroid4 = createModelVAO(createModelBuffer(ModelAsteroid4));
-
-    int offset = 0;
-    Asteroids = &Entities[offset];
-    offset += AsteroidCount;
-    Bullets = &Entities[offset];
-    offset += BulletCount;
-    ExplosionParticles = &Entities[offset];
-    offset += ExplosionParticleCount;
-    Ship = &Entities[offset];
-    offset += 1;
-    Texts = &Entities[offset];
-    offset += TextCount;
-
-    ScoreText = &Texts[0];
-
-    for (int i = 0; i < 1; i++) {
-        Entity *e = &Asteroids[i];
-        *e = (Entity){
-            .Active = true,
-            .Created = 0.0,
-            .Intensity = AsteroidIntensity,
-            .Position = (V2){Rand(-1.0, 1.0), Rand(-1.0, 1.0)},
-            .Velocity = (V2){Rand(-0.1, 0.1), Rand(-0.1, 0.1)},
-            .Model = ModelAsteroid4,
-            .VAO = VAOAsteroid4,
-            .AsteroidSize = AsteroidSizeLarge,
-        };
+    LineAttribTransform = glGetAttribLocation(LineProgram, "transform");
+    LineAttribOffset = glGetAttribLocation(LineProgram, "offset");
+    LineAttribIntensity = glGetAttribLocation(LineProgram, "lineIntensity");
+    LineAttribSegments = glGetAttribLocation(LineProgram, "lineSegments");
+
+    LineUniformSegments = glGetUniformLocation(LineProgram, "segments");
+
+    // there are no per vertex attributes, line.vsh pulls the segments itself
+    glGenVertexArrays(1, &LineVertexArray);
+    setVertexArray(LineVertexArray);
+    for (int column = 0; column < 3; column++) {
+        glEnableVertexAttribArray(LineAttribTransform + column);
+        glVertexAttribDivisor(LineAttribTransform + column, 1);
     }
-
-    *Ship = (Entity){
-        .Active = true,
-        .Intensity = ShipIntensity,
-        .Model = ModelShip,
-        .VAO = VAOShip,
-    };
-
-    *ScoreText = (Entity){
-        .Active = true,
-        .Intensity = ScoreIntensity,
-        .Position = (V2){0.8, 0.8},
-    };
-
-    Projection = M3Scale(M3Identity, (V2){(float)ScreenHeight / (float)ScreenWidth, 1.0});
-}
-
-bool collision(V2 center, Entity *e) {
-    V2 points[e->Model.Length];
-    for (int k = 0; k < e->Model.Length; k++) {
-        points[k] = M3MultiplyV2(e->Transform, e->Model.Data[k]);
+    glEnableVertexAttribArray(LineAttribOffset);
+    glVertexAttribDivisor(LineAttribOffset, 1);
+    glEnableVertexAttribArray(LineAttribIntensity);
+    glVertexAttribDivisor(LineAttribIntensity, 1);
+    glEnableVertexAttribArray(LineAttribSegments);
+    glVertexAttribDivisor(LineAttribSegments, 1);
+
+    addSegmentRange(ModelBullet);
+    addSegmentRange(ModelShip);
+    addSegmentRange(ModelAsteroid1);
+    addSegmentRange(ModelAsteroid2);
+    addSegmentRange(ModelAsteroid3);
+    addSegmentRange(ModelAsteroid4);
+    addGlyphRange();
+
+    uint64 seed = (uint64)time(NULL);
+    EffectRandom = seedRandom(~seed);
+    Arena arena = createArena(gameArenaSize(Config));
+    setupSimulation(&State, Config, arena, (float)ScreenWidth / (float)ScreenHeight, seed);
+
+    EntityPool *pools[EntityPoolCount];
+    gameEntityPools(&State, pools);
+    int capacity = 0;
+    for (int i = 0; i < EntityPoolCount; i++) {
+        capacity += pools[i]->Count;
     }
+    LineBatches = allocate(capacity * sizeof(LineBatch));
 
-    bool inside = false;
-    for (int k = 0; k < e->Model.Length; k += 2) {
-        V2 p1 = points[k];
-        V2 p2 = points[k + 1];
-        if ((p1.y > center.y) != (p2.y > center.y) && (center.x < (p2.x - p1.x) * (center.y - p1.y) / (p2.y - p1.y) + p1.x)) {
-            inside = !inside;
-        }
-    }
-    return inside;
+    // room for every entity and a screen of canvas text, it grows if needed
+    FrameArena = createArena(FrameArenaSize);
+    createStreamBuffer(&FrameStream, capacity * sizeof(LineInstance) + CanvasStreamSize, &FrameArena, "Frame Stream");
 }
 
-void destroyAsteroid(float t, Entity *a) {
-    for (int k = 0; k < 64; k++) {
-        int index = findInactiveEntity(ExplosionParticles, ExplosionParticleCount);
-        if (index == -1) {
-            break;
+// index of the batch for model among the batches from first on, adding one if
+// needed, -1 if the model has nothing to draw
+int lineBatch(int first, Model model) {
+    for (int b = first; b < LineBatchCount; b++) {
+        if (LineBatches[b].Model == model.Data) {
+            return b;
         }
-
-        // generate random spherical direction
-        M4 rotation = M4Rotate(M4Identity, Rand(-0.5, 0.5) * M_PI, (V3){1, 0, 0});
-        rotation = M4Rotate(rotation, Rand(0, 1.0) * 2 * M_PI, (V3){0, 0, 1});
-        V3 direction = M4MultiplyV3(rotation, (V3){1, 0, 0});
-        V2 velocity = V2MultiplyScalar((V2){direction.x, direction.y}, 0.2);
-        ExplosionParticles[index] = (Entity){
-            .Active = true,
-            .Velocity = velocity,
-            .Position = a->Position,
-            .Created = t,
-            .Intensity = Rand(0.5, 0.8),
-            .Model = ModelBullet,
-            .VAO = VAOBullet,
-        };
     }
 
-    if (a->AsteroidSize > AsteroidSizeSmall) {
-        // create two new asteroids
-        for (int asteroidNumber = 0; asteroidNumber < 2; asteroidNumber++) {
-            int index = findInactiveEntity(Asteroids, AsteroidCount);
-            if (index == -1) {
-                continue;
-            }
-
-            Asteroids[index] = (Entity){
-                .Active = true,
-                .Created = t,
-                .Intensity = AsteroidIntensity,
-                .Position = a->Position,
-                .Velocity = (V2){Rand(-0.1, 0.1), Rand(-0.1, 0.1)},
-                .Model = ModelAsteroid4,
-                .VAO = VAOAsteroid4,
-                .AsteroidSize = a->AsteroidSize - 1,
-            };
-        }
+    int range = segmentRange(model);
+    if (range == -1) {
+        return -1;
     }
-
-    a->Active = false;
-    Score++;
+    LineBatches[LineBatchCount] = (LineBatch){
+        .Model = model.Data,
+        .FirstSegment = SegmentRanges[range].First,
+        .VertexCount = model.Length / 2 * 6,
+    };
+    LineBatchCount++;
+    return LineBatchCount - 1;
 }
 
-void update(float64 t, float64 deltaT) {
-    if (InputRotateLeft) {
-        Ship->Rotation = Ship->Rotation - 3.0 / 180.0 * M_PI;
-    }
-
-    if (InputRotateRight) {
-        Ship->Rotation = Ship->Rotation + 3.0 / 180.0 * M_PI;
-    }
-
-    Ship->Velocity = V2MultiplyScalar(Ship->Velocity, 0.99);
-    if (InputAccelerate) {
-        // add velocity based on current direction
-        M3 transform = M3Rotate(M3Identity, Ship->Rotation);
-        V2 deltaV = M3MultiplyV2(transform, (V2){0, 0.02});
-        Ship->Velocity = V2Add(Ship->Velocity, deltaV);
-    }
-
-    if (InputFire && t - LastBulletTime > BulletInterval) {
-        int index = findInactiveEntity(Bullets, BulletCount);
-        if (index != -1) {
-            LastBulletTime = t;
-            M3 transform = M3Rotate(M3Identity, Ship->Rotation);
-            V2 velocity = M3MultiplyV2(transform, (V2){0, 3});
-            V2 position = V2Add(Ship->Position, M3MultiplyV2(transform, (V2){0, (float32)ModelShip.Height * Scale / 2.0}));
-            Bullets[index] = (Entity){
-                .Active = true,
-                .Created = t,
-                .Intensity = BulletIntensity,
-                .Position = position,
-                .Velocity = velocity,
-                .Model = ModelBullet,
-                .VAO = VAOBullet,
-            };
-        }
-    }
-
-    for (int i = 0; i < BulletCount; i++) {
-        Entity *b = &Bullets[i];
-
-        if (t - b->Created > BulletExpiration) {
-            b->Active = false;
-        }
-    }
+// the batch of every glyph instance among the batches from first on, each
+// instance draws its glyph's segments out of the longest glyph's worth
+int glyphBatch(int first) {
+    int b = lineBatch(first, GlyphModel);
+    LineBatches[b].VertexCount = MaxGlyphSegmentCount * 6;
+    return b;
+}
 
-    for (int i = 0; i < ExplosionParticleCount; i++) {
-        Entity *p = &ExplosionParticles[i];
-        if (!p->Active) {
+// count the active entities of pool into one batch per model, or the glyphs
+// of a text pool into the glyph batch, reserving their place in the frame's
+// instances, returns the pool's first batch
+int countEntities(const EntityPool *pool) {
+    int first = LineBatchCount;
+    for (int i = 0; i < pool->Count; i++) {
+        if (!pool->Active[i]) {
             continue;
         }
-        if (t - p->Created > ExplosionParticleExpiration) {
-            p->Active = false;
+        if (pool->Text != NULL) {
+            LineBatches[glyphBatch(first)].Count += glyphCount(pool->Text[i]);
             continue;
         }
+        int b = lineBatch(first, pool->Model[i]);
+        if (b != -1) {
+            LineBatches[b].Count++;
+        }
+    }
 
-        p->Intensity = p->Intensity * 0.98;
+    for (int b = first; b < LineBatchCount; b++) {
+        LineBatches[b].First = LineInstanceCount;
+        LineInstanceCount += LineBatches[b].Count;
+        LineBatches[b].Count = 0;
     }
+    return first;
+}
 
-    for (int i = 0; i < EntityCount; i++) {
-        Entity *e = &Entities[i];
-        if (!e->Active) {
+// one instance per glyph of text, placed the way measureText() lays them out
+void writeGlyphs(LineBatch *batch, const char *text, M3 transform, V2 offset, float32 intensity) {
+    float32 pen = 0;
+    for (int i = 0; text[i] != '\0'; i++) {
+        int c = text[i];
+        if (GlyphSegmentCount[c] == 0) {
             continue;
         }
+        LineInstances[batch->First + batch->Count] = (LineInstance){
+            .Transform = M3Multiply(transform, M3Translate(M3Identity, (V2){pen, BattleFont.Height})),
+            .Offset = offset,
+            .Intensity = intensity,
+            .FirstSegment = SegmentRanges[GlyphRange].First + GlyphFirstSegment[c],
+            .SegmentCount = GlyphSegmentCount[c],
+        };
+        batch->Count++;
+        pen += BattleFont.Characters[c].Width;
+    }
+}
 
-        e->Rotation = e->Rotation + e->RotationSpeed * deltaT;
-        V2 pos = e->Position;
-        pos = V2Add(pos, V2MultiplyScalar(e->Velocity, deltaT));
-
-        if (pos.x > 1) {
-            pos.x = pos.x - 2;
-        } else if (pos.x < -1) {
-            pos.x = pos.x + 2;
+// write the instances of the entities counted by countEntities()
+void writeEntities(const EntityPool *pool, int first) {
+    for (int i = 0; i < pool->Count; i++) {
+        if (!pool->Active[i]) {
+            continue;
         }
+        M3 transform = interpolatedTransform(pool, i, TickFraction, RenderProjection);
+        V2 offset = (V2){Rand(&EffectRandom, -1, 1), Rand(&EffectRandom, -2, 2)};
 
-        if (pos.y > 1) {
-            pos.y = pos.y - 2;
-        } else if (pos.y < -1) {
-            pos.y = pos.y + 2;
+        if (pool->Text != NULL) {
+            writeGlyphs(&LineBatches[glyphBatch(first)], pool->Text[i], transform, offset, pool->Intensity[i]);
+            continue;
         }
 
-        e->Position = pos;
-
-        Model model = e->Model;
-
-        M3 m = Projection;
-        m = M3Translate(m, e->Position);
-        m = M3Scale(m, (V2){Scale, Scale});
-        if (e->AsteroidSize == AsteroidSizeMedium) {
-            m = M3Scale(m, (V2){0.5, 0.5});
-        } else if (e->AsteroidSize == AsteroidSizeSmall) {
-            m = M3Scale(m, (V2){0.25, 0.25});
+        int b = lineBatch(first, pool->Model[i]);
+        if (b == -1) {
+            continue;
         }
-        m = M3Rotate(m, e->Rotation);
-        m = M3Translate(m, (V2){(float)-model.Width / 2.0, (float)-model.Height / 2.0});
-        e->Transform = m;
+        LineBatch *batch = &LineBatches[b];
+        LineInstances[batch->First + batch->Count] = (LineInstance){
+            .Transform = transform,
+            .Offset = offset,
+            .Intensity = pool->Intensity[i],
+            .FirstSegment = batch->FirstSegment,
+            .SegmentCount = batch->VertexCount / 6,
+        };
+        batch->Count++;
     }
+}
 
-    // check for intersection of bullet and asteroid
-    for (int j = 0; j < AsteroidCount; j++) {
-        Entity *a = &Asteroids[j];
+void drawLineBatches(int first, int end) {
+    for (int b = first; b < end; b++) {
+        LineBatch *batch = &LineBatches[b];
+        pointLineInstances(batch->First);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, batch->VertexCount, batch->Count);
+        EntityDrawCalls++;
+    }
+}
 
-        if (!a->Active || a->Created == t) {
-            continue;
-        }
+// the passes of the frame's render graph, each draws into its first output
 
-        for (int i = 0; i < BulletCount; i++) {
-            Entity *b = &Bullets[i];
+void decayPass(RenderGraph *graph, RenderPass *pass) {
+    bindPassOutput(graph, pass);
+    glClear(GL_COLOR_BUFFER_BIT);
+    setBlend(false);
+    setProgram(DecayProgram);
+    setVertexArray(DecayVertexArray);
+    glUniform1f(DecayUniformDecay, DecayConstant);
+    setTexture(0, passInput(graph, pass, 0));
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
 
-            if (!b->Active) {
-                continue;
-            }
+// Param is the number of batches clipped to the playfield, the rest are text
+void entitiesPass(RenderGraph *graph, RenderPass *pass) {
+    pushProfile("drawEntities");
+    bindPassOutput(graph, pass);
+    setProgram(LineProgram);
+    setBlend(true);
+    setBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
+    glUniform2f(LineUniformResolution, TargetWidth, TargetHeight);
+    glUniform1f(LineUniformWidth, LineWidthPixels);
 
-            // check if center of bullet is inside asteroid
-            if (!collision(b->Position, a)) {
-                continue;
-            }
+    int offset = (TargetWidth - TargetHeight) / 2;
+
+    EntityDrawCalls = 0;
+    setVertexArray(LineVertexArray);
+    setTexture(0, SegmentTexture);
+    glUniform1i(LineUniformSegments, 0);
+    setScissorBox(offset, 0, TargetWidth - offset * 2, TargetHeight);
+    setScissor(true);
+    drawLineBatches(0, pass->Param);
+    setScissor(false);
+    drawLineBatches(pass->Param, LineBatchCount);
+    setBlend(false);
+    popProfile();
+}
 
-            destroyAsteroid(t, a);
-            b->Active = false;
-        }
+// threshold and shrink to the output's size, threshold.fsh samples every
+// input pixel
+void thresholdPass(RenderGraph *graph, RenderPass *pass) {
+    bindPassOutput(graph, pass);
+    glClear(GL_COLOR_BUFFER_BIT);
+    setProgram(ThresholdProgram);
+    setVertexArray(ThresholdVertexArray);
+    setTexture(0, passInput(graph, pass, 0));
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
 
-        if (collision(Ship->Position, a)) {
-            destroyAsteroid(t, a);
-        }
-    }
+// Param is true for a horizontal pass
+void blurPass(RenderGraph *graph, RenderPass *pass) {
+    bindPassOutput(graph, pass);
+    glClear(GL_COLOR_BUFFER_BIT);
+    setProgram(BlurProgram);
+    setVertexArray(BlurVertexArray);
+    setTexture(0, passInput(graph, pass, 0));
+    glUniform1ui(BlurHorizontal, pass->Param);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
 
-    // update score
-    {
-        if (ScoreText->Model.Data != NULL) {
-            free(ScoreText->Model.Data);
-            glDeleteVertexArrays(1, &ScoreText->VAO);
-            glDeleteBuffers(1, &ScoreText->VBO);
-        }
+// upscales the frame, rendered at RenderScale, to the screen
+void blendPass(RenderGraph *graph, RenderPass *pass) {
+    bindPassOutput(graph, pass);
+    glClear(GL_COLOR_BUFFER_BIT);
+    setProgram(BlendProgram);
+    setVertexArray(BlendVertexArray);
+    setTexture(0, passInput(graph, pass, 0));
+    glUniform1i(BlendUniformOriginal, 0);
+    setTexture(1, passInput(graph, pass, 1));
+    glUniform1i(BlendUniformBloom, 1);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
 
-        char buf[8];
-        snprintf(buf, 8, "%d", Score);
-        ScoreText->Model = createTextModel(buf);
-        ScoreText->VBO = createModelBuffer(ScoreText->Model);
-        ScoreText->VAO = createModelVAO(ScoreText->VBO);
-    }
+void canvasPass(RenderGraph *graph, RenderPass *pass) {
+    bindPassOutput(graph, pass);
+    renderCanvas();
 }
 
-int findInactiveEntity(Entity *entities, int count) {
-    for (int i = 0; i < count; i++) {
-        if (!entities[i].Active) {
-            return i;
-        }
+// describe the frame's passes by what they read and write, the bloom targets
+// only live from the threshold to the blend
+void buildFrameGraph(RenderGraph *graph, int playfieldBatches) {
+    resetRenderGraph(graph);
+    int previous = importTarget(graph, "Previous Frame", PreviousTarget);
+    int current = importTarget(graph, "Frame", CurrentTarget);
+    int screen = importFramebuffer(graph, "Screen", ScreenFramebuffer, ScreenWidth, ScreenHeight);
+
+    RenderPass *pass = addRenderPass(graph, "Previous Frame", decayPass, 0);
+    readResource(pass, previous);
+    writeResource(pass, current);
+
+    pass = addRenderPass(graph, "Entities", entitiesPass, playfieldBatches);
+    readResource(pass, current); // blended onto
+    writeResource(pass, current);
+
+    // an eighth of the frame for threshold.fsh, linear for blur.fsh's
+    // bilinear fetches
+    int bloom = createTransient(graph, "Bloom", TargetWidth / 8, TargetHeight / 8, GL_RGBA8, GL_LINEAR);
+    pass = addRenderPass(graph, "Threshold", thresholdPass, 0);
+    readResource(pass, current);
+    writeResource(pass, bloom);
+
+    // a new transient per blur pass, alternate ones end up sharing a target
+    for (int i = 0; i < BlurQualities[BlurTier].Passes; i++) {
+        int blurred = createTransient(graph, "Bloom", TargetWidth / 8, TargetHeight / 8, GL_RGBA8, GL_LINEAR);
+        pass = addRenderPass(graph, "Blur", blurPass, i % 2 == 1);
+        readResource(pass, bloom);
+        writeResource(pass, blurred);
+        bloom = blurred;
     }
-    return -1;
-}
 
-void drawEntities(Entity *entities, int count) {
-    GLuint lastVAO = 0;
-    for (int i = 0; i < count; i++) {
-        Entity e = entities[i];
-        if (!e.Active) {
-            continue;
-        }
+    pass = addRenderPass(graph, "Blend", blendPass, 0);
+    readResource(pass, current);
+    readResource(pass, bloom);
+    writeResource(pass, screen);
 
-        if (lastVAO != e.VAO) {
-            glBindVertexArray(e.VAO);
-            lastVAO = e.VAO;
-        }
-        glUniform2f(LineUniformOffset, Rand(-1, 1), Rand(-2, 2));
-        glUniform1f(LineUniformIntensity, e.Intensity);
-        glUniformMatrix3fv(LineUniformTransform, 1, 0, e.Transform.m);
-        Model model = e.Model;
-        glDrawArrays(GL_TRIANGLES, 0, model.Length / 2 * 6);
+    if (CanvasBatchCount > 0) {
+        pass = addRenderPass(graph, "Canvas", canvasPass, 0);
+        writeResource(pass, screen);
     }
+
+    compileRenderGraph(graph);
 }
 
 void frame(float64 t) {
+    pushProfile("frame");
     if (LastTimestamp == 0) {
         LastTimestamp = t;
     }
     float64 deltaT = t - LastTimestamp;
     LastTimestamp = t;
 
+#ifdef DEBUG
+    int allocations = heapAllocations();
+#endif
+    resetArena(&FrameArena);
+
     if (PauseMode) {
         // don't increment time in PauseMode
         // also no need to update the world
     } else {
-        Time += deltaT;
-        update(Time, deltaT);
+        TickFraction = advanceSimulation(&State, deltaT);
     }
 
-    //    initCanvas();
-
-    glBindFramebuffer(GL_FRAMEBUFFER, CurrentFramebuffer);
-    glClear(GL_COLOR_BUFFER_BIT);
-
-    glPushGroupMarker("Previous Frame");
-    glUseProgram(DecayProgram);
-    glBindVertexArray(DecayVertexArray);
-    glUniform1f(DecayUniformDecay, DecayConstant);
-    glBindTexture(GL_TEXTURE_2D, PreviousTexture);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glBindVertexArray(0);
-    glUseProgram(0);
-    glPopGroupMarker();
-
-    glPushGroupMarker("Entities");
-    glUseProgram(LineProgram);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
-    glUniform2f(LineUniformResolution, ScreenWidth, ScreenHeight);
-    glUniform1f(LineUniformWidth, LineWidthPixels);
-
-    int offset = (ScreenWidth - ScreenHeight) / 2;
-
-    glScissor(offset, 0, ScreenWidth - offset * 2, ScreenHeight);
-    glEnable(GL_SCISSOR_TEST);
-    drawEntities(Asteroids, AsteroidCount);
-    drawEntities(Bullets, BulletCount);
-    drawEntities(ExplosionParticles, ExplosionParticleCount);
-    drawEntities(Ship, 1);
-    glDisable(GL_SCISSOR_TEST);
-    drawEntities(Texts, TextCount);
-
-    glBindVertexArray(0);
-    glUseProgram(0);
-    glDisable(GL_BLEND);
-    glBlendFunc(GL_ONE, GL_ZERO);
-    glPopGroupMarker();
-
-    // resize in stages so that small version of texture is sampled from all input pixels
-    glPushGroupMarker("Threshold");
-    glViewport(0, 0, ScreenWidth / 2, ScreenHeight / 2);
-    glBindFramebuffer(GL_FRAMEBUFFER, HalfFramebuffer);
-    glClear(GL_COLOR_BUFFER_BIT);
-    glUseProgram(ThresholdProgram);
-    glBindVertexArray(ThresholdVertexArray);
-    glBindTexture(GL_TEXTURE_2D, CurrentTexture);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glBindVertexArray(0);
-    glUseProgram(0);
-    glPopGroupMarker();
-
-    glUseProgram(CopyProgram);
-    glBindVertexArray(CopyVertexArray);
-
-    glPushGroupMarker("Resize to Quarter");
-    glViewport(0, 0, ScreenWidth / 4, ScreenHeight / 4);
-    glBindFramebuffer(GL_FRAMEBUFFER, QuarterFramebuffer);
-    glClear(GL_COLOR_BUFFER_BIT);
-    glBindTexture(GL_TEXTURE_2D, HalfTexture);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glPopGroupMarker();
-
-    glPushGroupMarker("Resize to Eighth");
-    glViewport(0, 0, ScreenWidth / 8, ScreenHeight / 8);
-    glBindFramebuffer(GL_FRAMEBUFFER, BlurFramebufferA);
-    glClear(GL_COLOR_BUFFER_BIT);
-    glBindTexture(GL_TEXTURE_2D, QuarterTexture);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glPopGroupMarker();
+    initCanvas();
 
-    glUseProgram(0);
-    glBindVertexArray(0);
+    // before the entities are written with RenderProjection
+    updateRenderScale(deltaT);
+    sizeRenderTargets();
 
-    glPushGroupMarker("Blur");
-    GLuint BlurReadFramebuffer = BlurFramebufferA;
-    GLuint BlurReadTexture = BlurTextureA;
-    GLuint BlurWriteFramebuffer = BlurFramebufferB;
-    GLuint BlurWriteTexture = BlurTextureB;
+    // everything streamed this frame is written before the first draw, so
+    // that the region is mapped and flushed only once
+    beginStreamFrame(&FrameStream);
 
-    glUseProgram(BlurProgram);
-    glBindVertexArray(BlurVertexArray);
-    //    int blurFactor = (int)(LineWidthPixels / 8);
-    int blurFactor = 1;
-    if (blurFactor == 0) {
-        blurFactor = 1;
+    pushProfile("writeEntities");
+    const EntityPool *pools[] = {&State.Asteroids, &State.Bullets, &State.ExplosionParticles, &State.Ship, &State.Texts};
+    int poolBatches[EntityPoolCount];
+    LineInstanceCount = 0;
+    LineBatchCount = 0;
+    for (int p = 0; p < EntityPoolCount; p++) {
+        poolBatches[p] = countEntities(pools[p]);
     }
+    int playfieldBatches = poolBatches[EntityPoolCount - 1]; // all but the texts
+    LineInstanceOffset = streamAlloc(&FrameStream, LineInstanceCount * sizeof(LineInstance), (void **)&LineInstances);
+    for (int p = 0; p < EntityPoolCount; p++) {
+        writeEntities(pools[p], poolBatches[p]);
+    }
+    popProfile();
 
-    // only blur once in vertical direction
-    glBindFramebuffer(GL_FRAMEBUFFER, BlurWriteFramebuffer);
-    glClear(GL_COLOR_BUFFER_BIT);
-    glBindTexture(GL_TEXTURE_2D, BlurReadTexture);
-    glUniform1ui(BlurHorizontal, false);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    GLSWAP(BlurReadFramebuffer, BlurWriteFramebuffer);
-    GLSWAP(BlurReadTexture, BlurWriteTexture);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, BlurWriteFramebuffer);
-    glClear(GL_COLOR_BUFFER_BIT);
-    glBindTexture(GL_TEXTURE_2D, BlurReadTexture);
-    glUniform1ui(BlurHorizontal, true);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    GLSWAP(BlurReadFramebuffer, BlurWriteFramebuffer);
-    GLSWAP(BlurReadTexture, BlurWriteTexture);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, BlurWriteFramebuffer);
-    glClear(GL_COLOR_BUFFER_BIT);
-    glBindTexture(GL_TEXTURE_2D, BlurReadTexture);
-    glUniform1ui(BlurHorizontal, false);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    GLSWAP(BlurReadFramebuffer, BlurWriteFramebuffer);
-    GLSWAP(BlurReadTexture, BlurWriteTexture);
+    if (ShowGPUTimes) {
+        int y = ScreenHeight - DrawFont.Height;
+        drawGPUTimes(DrawFont.Width, y);
+        // below the header and a line per pass, after a blank line
+        drawFrameStats(DrawFont.Width, y - (GPUPassCount + 2) * DrawFont.Height);
+    }
+    streamCanvas(&FrameStream);
+    endStreamFrame(&FrameStream);
 
-    glUseProgram(0);
-    glBindVertexArray(0);
-    glPopGroupMarker();
+    beginGPUTimerFrame();
 
-    glViewport(0, 0, ScreenWidth, ScreenHeight);
+    buildFrameGraph(&FrameGraph, playfieldBatches);
+    executeRenderGraph(&FrameGraph);
 
-    glPushGroupMarker("Blend");
-    glBindFramebuffer(GL_FRAMEBUFFER, ScreenFramebuffer);
-    glClear(GL_COLOR_BUFFER_BIT);
-    glUseProgram(BlendProgram);
-    glBindVertexArray(BlendVertexArray);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, CurrentTexture);
-    glUniform1i(BlendUniformOriginal, 0);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, BlurReadTexture);
-    glUniform1i(BlendUniformBloom, 1);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glUseProgram(0);
-    glBindVertexArray(0);
-    glPopGroupMarker();
+    fenceStreamFrame(&FrameStream);
+    endGLStateFrame();
 
 #if TARGET_OS_IPHONE
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, ScreenFramebuffer);
+        setFramebuffer(ScreenFramebuffer);
         const GLenum discards[] = {GL_DEPTH_ATTACHMENT};
         glInvalidateFramebuffer(GL_FRAMEBUFFER, 1, discards);
     }
 #endif
 
-    // flip textures
-    {
-        GLuint t = PreviousFramebuffer;
-        PreviousFramebuffer = CurrentFramebuffer;
-        CurrentFramebuffer = t;
+#ifdef DEBUG
+    // everything transient belongs in FrameArena, buffers that grow have
+    // reached their size by now
+    if (FrameCount >= WarmupFrames && heapAllocations() != allocations) {
+        fatal("frame %llu made %d heap allocations", FrameCount, heapAllocations() - allocations);
     }
+#endif
+    FrameCount++;
+    trimRenderTargets();
 
+    // flip textures
     {
-        GLuint t = PreviousTexture;
-        PreviousTexture = CurrentTexture;
-        CurrentTexture = t;
+        RenderTarget *t = PreviousTarget;
+        PreviousTarget = CurrentTarget;
+        CurrentTarget = t;
     }
+    popProfile();
 }
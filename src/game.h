@@ -1,14 +1,85 @@
 /* This file was automatically generated.  Do not edit! */
-#define GLSWAP(x, y)  \
-    do {              \
-        GLuint t = x; \
-        x = y;        \
-        y = t;        \
-    } while (0)
-void glPopGroupMarker();
-void glPushGroupMarker(char *str);
-typedef double float64;
-void frame(float64 t);
+void trimRenderTargets();
+void endGLStateFrame();
+#define StreamFrameCount 3     // frames the GPU may still be reading while the next is written
+typedef uint8_t uint8;
+typedef size_t memory_index;
+typedef struct {
+    uint8 *Base;
+    memory_index Size;
+    memory_index Used;
+}Arena;
+typedef uint64_t uint64;
+typedef struct {
+    GLuint Buffer;
+    GLsizeiptr FrameSize;
+    int Frame;
+    GLsync Fences[StreamFrameCount];
+    Arena *Scratch; // per frame memory, holds the written data while the buffer grows
+
+    // the frame being written, offsets from streamAlloc() are relative to Base
+    GLintptr Base;
+    uint8 *Mapped;
+    GLsizeiptr Used;
+
+    GLsizeiptr FrameBytes; // streamed by the last finished frame
+    uint64 TotalBytes;
+    int Stalls; // frames that had to wait for the GPU to release their region
+}StreamBuffer;
+void fenceStreamFrame(StreamBuffer *stream);
+typedef struct RenderGraph RenderGraph;
+typedef struct {
+    GLuint Texture;
+    GLuint Framebuffer;
+    int Width;
+    int Height;
+    GLenum Format; // sized internal format
+    GLenum Filter; // both min and mag
+    bool Acquired;
+    uint64 Released; // RenderTargetFrame when last released
+}RenderTarget;
+typedef struct {
+    char *Name;
+    int Width;
+    int Height;
+    GLenum Format;
+    GLenum Filter;
+    bool Imported;
+    RenderTarget *Target;
+    GLuint Framebuffer; // of Target, or the imported framebuffer
+    int FirstPass;      // of the passes that run, -1 if none use it
+    int LastPass;
+}GraphResource;
+#define MaxGraphResources 16
+typedef struct RenderPass RenderPass;
+#define MaxPassResources 4
+struct RenderPass {
+    char *Name;
+    void (*Execute)(RenderGraph *graph, RenderPass *pass);
+    int Param; // for Execute
+    int Inputs[MaxPassResources];
+    int InputCount;
+    int Outputs[MaxPassResources];
+    int OutputCount;
+    bool Culled;
+};
+#define MaxGraphPasses 16
+struct RenderGraph {
+    GraphResource Resources[MaxGraphResources];
+    int ResourceCount;
+    RenderPass Passes[MaxGraphPasses];
+    int PassCount;
+    int CulledPasses;
+};
+void executeRenderGraph(RenderGraph *graph);
+void beginGPUTimerFrame();
+void endStreamFrame(StreamBuffer *stream);
+void streamCanvas(StreamBuffer *stream);
+extern int GPUPassCount;
+void drawGPUTimes(int x,int y);
+GLintptr streamAlloc(StreamBuffer *stream,GLsizeiptr size,void **data);
+void beginStreamFrame(StreamBuffer *stream);
+void initCanvas();
 typedef float float32;
 typedef union {
     struct {
@@ -17,53 +88,158 @@ typedef union {
     };
     float32 m[2];
 }V2;
+typedef struct {
+    float32 m[9];
+}M3;
+typedef double float64;
 typedef struct {
     int Width;
     int Height;
     int Length;
     V2 *Data;
 }Model;
+#define MaxTextLength 8 // characters in a text entity, including the terminator
 typedef struct {
-    float32 m[9];
-}M3;
+    int Count;
+    int FreeCount;
+    int *Free; // stack of inactive indices, spawnEntity pops and despawnEntity pushes
+    bool *Active;
+    V2 *Position;
+    V2 *Velocity;
+    float32 *Rotation;
+    V2 *PreviousPosition; // at the start of the last tick, for render interpolation
+    float32 *PreviousRotation;
+    float32 *RotationSpeed;
+    M3 *Transform;
+    float32 *Intensity;
+    float64 *Created;
+    Model *Model;
+    int *AsteroidSize;
+    float32 *Radius; // model space bounding radius around the model center
+
+    // per tick cache of the collision polygon, only allocated for pools that
+    // are tested with collision()
+    int PolygonStride;
+    uint64 *PolygonTick;
+    V2 *Polygon;
+
+    // only for the text pool, the string each entity shows, its Model only
+    // has the size
+    char (*Text)[MaxTextLength];
+}EntityPool;
+#define GridSize 16 // cells per axis over the wrapped [-1, 1] playfield
+#define GridCellCount (GridSize * GridSize)
 typedef struct {
-    bool Active;
-    V2 Position;
-    V2 Velocity;
-    float32 Intensity;
-    float32 Rotation;      // radians
-    float32 RotationSpeed; // radians per second
-    GLuint VBO;
-    GLuint VAO;
-    Model Model;
-    float64 Created;
-    M3 Transform;
-    int AsteroidSize;
-}Entity;
-void drawEntities(Entity *entities,int count);
-V2 V2Add(V2 vl,V2 vr);
-M3 M3Rotate(M3 m,float32 radians);
-void update(float64 t,float64 deltaT);
-V2 V2MultiplyScalar(V2 v,float32 s);
-typedef union {
-    struct {
-        float32 x;
-        float32 y;
-        float32 z;
-    };
-    float32 m[3];
-}V3;
-typedef struct {
-    float32 m[16];
-}M4;
-V3 M4MultiplyV3(M4 m,V3 v);
-extern const M4 M4Identity;
-M4 M4Rotate(M4 m,float32 radians,V3 axis);
-int findInactiveEntity(Entity *entities,int count);
-void destroyAsteroid(float t,Entity *a);
-bool collision(V2 center,Entity *e);
-M3 M3Scale(M3 m,V2 v);
-float32 Rand(float32 min,float32 max);
+    int CellStart[GridCellCount + 1]; // Items[CellStart[c]..CellStart[c + 1]] are in cell c
+    int Length;
+    int Capacity;
+    int *Items; // entity indices sorted by cell
+}Grid;
+typedef uint32_t uint32;
+typedef struct {
+    uint32 Words[4];
+}Random;
+#define RandomLaneCount 8
+typedef struct {
+    uint32 Words[4][RandomLaneCount];
+}RandomLanes;
+typedef struct {
+    bool RotateLeft;
+    bool RotateRight;
+    bool Fire;
+    bool Accelerate;
+}GameInput;
+typedef struct {
+    Arena Memory; // backs every EntityPool
+    EntityPool Asteroids;
+    EntityPool Bullets;
+    EntityPool Ship;
+    EntityPool ExplosionParticles;
+    EntityPool Texts;
+    Grid AsteroidGrid;
+    int ScoreText;  // index into Texts
+    int ShownScore; // the score ScoreText shows
+    M3 Projection;
+
+    Random Random;
+    RandomLanes ParticleRandom; // for bulk draws when spawning particles
+
+    GameInput Input;
+    int Score;
+    int Wave;
+    float64 Time;
+    float64 TickDuration;
+    float64 Accumulator; // time passed to advanceSimulation() not yet simulated
+    float64 LastBulletTime;
+    uint64 Tick; // number of update() calls, starts at 1 so that 0 is never current
+
+    // counters for checking the effectiveness of the polygon cache and
+    // bounding circle rejection under load
+    int PolygonCacheHits;
+    int PolygonCacheMisses;
+    int BoundingCircleRejects;
+}Game;
+float32 advanceSimulation(Game *game,float64 elapsed);
+void resetArena(Arena *arena);
+int heapAllocations();
+void frame(float64 t);
+void compileRenderGraph(RenderGraph *graph);
+extern int CanvasBatchCount;
+int createTransient(RenderGraph *graph,char *name,int width,int height,GLenum format,GLenum filter);
+void writeResource(RenderPass *pass,int resource);
+void readResource(RenderPass *pass,int resource);
+RenderPass *addRenderPass(RenderGraph *graph,char *name,void(*execute)(RenderGraph *graph,RenderPass *pass),int param);
+int importFramebuffer(RenderGraph *graph,char *name,GLuint framebuffer,int width,int height);
+int importTarget(RenderGraph *graph,char *name,RenderTarget *target);
+void resetRenderGraph(RenderGraph *graph);
+void buildFrameGraph(RenderGraph *graph,int playfieldBatches);
+void renderCanvas();
+void canvasPass(RenderGraph *graph,RenderPass *pass);
+void blendPass(RenderGraph *graph,RenderPass *pass);
+void blurPass(RenderGraph *graph,RenderPass *pass);
+void thresholdPass(RenderGraph *graph,RenderPass *pass);
+void popProfile();
+void setScissorBox(GLint x,GLint y,GLsizei width,GLsizei height);
+void setBlendFunc(GLenum source,GLenum destination);
+void pushProfile(const char *name);
+void entitiesPass(RenderGraph *graph,RenderPass *pass);
+GLuint passInput(RenderGraph *graph,RenderPass *pass,int input);
+void setBlend(bool enabled);
+void bindPassOutput(RenderGraph *graph,RenderPass *pass);
+void decayPass(RenderGraph *graph,RenderPass *pass);
+void drawLineBatches(int first,int end);
+float32 Rand(Random *random,float32 min,float32 max);
+M3 interpolatedTransform(const EntityPool *pool,int index,float32 alpha,M3 projection);
+void writeEntities(const EntityPool *pool,int first);
+M3 M3Translate(M3 m,V2 v);
+M3 M3Multiply(M3 ml,M3 mr);
+typedef struct {
+    const V2 *Model;
+    int FirstSegment; // in SegmentTexture
+    int VertexCount;
+    int First;
+    int Count;
+}LineBatch;
+void writeGlyphs(LineBatch *batch,const char *text,M3 transform,V2 offset,float32 intensity);
+int countEntities(const EntityPool *pool);
+int glyphBatch(int first);
+int lineBatch(int first,Model model);
+#define CanvasStreamSize (64 * 1024) // bytes of canvas vertices expected per frame
+void createStreamBuffer(StreamBuffer *stream,GLsizeiptr frameSize,Arena *scratch,char *label);
+#define EntityPoolCount 5
+void gameEntityPools(Game *game,EntityPool *pools[EntityPoolCount]);
+typedef struct {
+    int TickRate; // updates per second, independent of the display
+    int AsteroidCount;
+    int BulletCount;
+    int TextCount;
+    int ExplosionParticleCount;
+}GameConfig;
+void setupSimulation(Game *game,GameConfig config,Arena arena,float32 aspect,uint64 seed);
+extern GameConfig Config;
+memory_index gameArenaSize(GameConfig config);
+Arena createArena(memory_index size);
+Random seedRandom(uint64 seed);
 extern Model ModelAsteroid4;
 extern Model ModelAsteroid3;
 extern Model ModelAsteroid2;
@@ -72,8 +248,6 @@ extern Model ModelShip;
 extern Model ModelBullet;
 extern const char *const LineFragmentSource;
 extern const char *const LineVertexSource;
-extern const char *const CopyFragmentSource;
-extern const char *const CopyVertexSource;
 extern const char *const BlendFragmentSource;
 extern const char *const BlendVertexSource;
 extern const char *const BlurFragmentSource;
@@ -83,109 +257,195 @@ extern const char *const ThresholdVertexSource;
 extern const char *const DecayFragmentSource;
 extern const char *const DecayVertexSource;
 GLuint compileProgram(const char *const vertexShaderSource,const char *const fragmentShaderSource,char *name);
+void setupGPUTimers();
 void setupCanvas();
+void setViewport(GLint x,GLint y,GLsizei width,GLsizei height);
+void invalidateGLState();
 void setup();
+void setVertexArray(GLuint array);
 void setupFullscreenQuad(GLuint program,GLuint *array);
+void setProgram(GLuint program);
+typedef struct {
+    int Radius; // texels each side, at most (MaxBlurTaps - 1) * 2
+    float32 Sigma;
+    int Passes;
+}BlurQuality;
+int blurKernel(BlurQuality quality,float32 *offsets,float32 *weights);
 #define BUFFER_OFFSET(i) ((char *)NULL + (i))
-GLuint createModelVAO(GLuint buffer);
-GLuint createModelBuffer(Model m);
-V2 M3MultiplyV2(M3 ml,V2 vr);
-M3 M3Translate(M3 m,V2 v);
-extern const M3 M3Identity;
+void pointLineInstances(int first);
+int segmentRange(Model model);
+int glyphCount(const char *text);
+void *allocate(size_t size);
 typedef struct {
 	int Height;
 	int Length;
 	Model Characters[];
 }ModelFont;
 extern ModelFont BattleFont;
-Model createTextModel(char *text);
-void checkFramebuffer();
-void glLabelObject(GLenum type,GLuint object,char *label);
-void generateTextureFramebuffer(GLuint *texture,GLuint *framebuffer,int scale,char *name);
+void addGlyphRange();
+void fatal(const char *fmt,...);
+int addSegmentRange(Model model);
+void deleteTexture(GLuint texture);
+void reserveSegments(int count);
+void setTexture(int unit,GLuint texture);
+typedef struct {
+    Model Model;
+    int First;
+}SegmentRange;
+void uploadSegments(SegmentRange range);
+void releaseRenderTarget(RenderTarget *target);
+void setScissor(bool enabled);
+void setFramebuffer(GLuint framebuffer);
+RenderTarget *acquireRenderTarget(int width,int height,GLenum format,GLenum filter,char *name);
+extern const M3 M3Identity;
+M3 M3Scale(M3 m,V2 v);
+void sizeRenderTargets();
+extern float64 GPUFrameTime;
+extern bool GPUTimersAvailable;
+void updateRenderScale(float64 deltaT);
 void touchInput(float x,float y);
+bool writeChromeTrace(char *path);
+void enableProfiler(bool enabled);
+bool profilerEnabled();
+void drawText(char *text,int x,int y);
+typedef struct {
+    int Width;
+    int Height;
+    int Chars;
+    uint8_t *Data;
+}Font;
+extern Font DrawFont;
+#define MaxTextureUnits 4
+typedef struct {
+    GLint Program;
+    GLint VertexArray;
+    GLint Framebuffer;
+    GLint ActiveUnit;
+    GLint Textures[MaxTextureUnits]; // GL_TEXTURE_2D of each unit
+    GLint Viewport[4];
+    GLint Blend;
+    GLint BlendSource;
+    GLint BlendDestination;
+    GLint Scissor;
+    GLint ScissorBox[4];
+
+    int Issued; // calls that changed state
+    int Skipped; // calls avoided since setup
+    int FrameIssued; // by the last frame, from endGLStateFrame()
+    int FrameSkipped;
+    int EndIssued; // the totals when the last frame ended
+    int EndSkipped;
+}GLStateCache;
+extern GLStateCache GLState;
+void drawFrameStats(int x,int y);
+bool dumpGPUTimes(char *path);
+bool sweptCollisionScene(Game *game);
+void setBlurQuality(int tier);
+void toggleProfiler();
+void logGPUTimes();
 void keyboardInput(int code,bool down);
-extern float64 LastBulletTime;
 extern float64 LastTimestamp;
 extern float64 DeltaTime;
-extern float64 Time;
+extern bool ShowGPUTimes;
 extern bool PauseMode;
-extern bool InputAccelerate;
-extern bool InputFire;
-extern bool InputRotateRight;
-extern bool InputRotateLeft;
+extern float32 TickFraction;
+extern Random EffectRandom;
+extern Game State;
 extern float32 QuadData[];
-extern M3 Projection;
-extern GLuint VAOAsteroid4;
-extern GLuint VAOAsteroid3;
-extern GLuint VAOAsteroid2;
-extern GLuint VAOAsteroid1;
-extern GLuint VAOShip;
-extern GLuint VAOBullet;
-extern Entity *ScoreText;
-extern Entity *Texts;
-extern Entity *ExplosionParticles;
-extern Entity *Ship;
-extern Entity *Bullets;
-extern Entity *Asteroids;
-#define AsteroidCount 128
-#define BulletCount 3
-#define TextCount 16
-#define ExplosionParticleCount 256
-#define EntityCount 1 + AsteroidCount + BulletCount + TextCount + ExplosionParticleCount
-extern Entity Entities[EntityCount];
-typedef uint8_t uint8;
 extern uint8 ImageBuffer[2048 *2048 *4];
 extern GLuint CubeVertexArray;
-extern GLuint CopyVertexArray;
-extern GLuint CopyProgram;
-extern GLuint LineUniformOffset;
-extern GLuint LineUniformIntensity;
+extern int MaxGlyphSegmentCount;
+#define MaxGlyphs 128
+extern int GlyphSegmentCount[MaxGlyphs];
+extern int GlyphFirstSegment[MaxGlyphs];
+extern int GlyphRange;
+extern Model GlyphModel;
+extern int SegmentRangeCount;
+#define MaxSegmentRanges 16
+extern SegmentRange SegmentRanges[MaxSegmentRanges];
+extern int SegmentCapacity;
+extern GLuint SegmentTexture;
+extern int EntityDrawCalls;
+extern int LineBatchCount;
+extern LineBatch *LineBatches;
+extern int LineInstanceCount;
+extern GLintptr LineInstanceOffset;
+typedef int32_t int32;
+typedef struct {
+    M3 Transform;
+    V2 Offset; // jitter in model space
+    float32 Intensity;
+    int32 FirstSegment; // in SegmentTexture
+    int32 SegmentCount; // segments beyond this are not drawn
+}LineInstance;
+extern LineInstance *LineInstances;
+extern uint64 FrameCount;
+extern Arena FrameArena;
+extern StreamBuffer FrameStream;
+extern GLuint LineAttribSegments;
+extern GLuint LineAttribIntensity;
+extern GLuint LineAttribOffset;
+extern GLuint LineAttribTransform;
+extern GLuint LineUniformSegments;
 extern GLuint LineUniformWidth;
 extern GLuint LineUniformResolution;
-extern GLuint LineUniformTransform;
+extern GLuint LineVertexArray;
 extern GLuint LineProgram;
 extern GLuint BlendUniformBloom;
 extern GLuint BlendUniformOriginal;
-extern GLuint BlendFramebuffer;
-extern GLuint BlendTexture;
 extern GLuint BlendVertexArray;
 extern GLuint BlendProgram;
-extern GLuint BlurFramebufferB;
-extern GLuint BlurTextureB;
-extern GLuint BlurFramebufferA;
-extern GLuint BlurTextureA;
+extern int BlurTier;
+extern BlurQuality BlurQualities[];
 extern GLuint BlurVertexArray;
+extern GLuint BlurUniformWeights;
+extern GLuint BlurUniformOffsets;
+extern GLuint BlurUniformTapCount;
 extern GLuint BlurHorizontal;
 extern GLuint BlurProgram;
 extern GLuint DecayUniformDecay;
 extern GLuint DecayVertexArray;
 extern GLuint DecayProgram;
-extern GLuint QuarterFramebuffer;
-extern GLuint QuarterTexture;
-extern GLuint HalfFramebuffer;
-extern GLuint HalfTexture;
 extern GLuint ThresholdVertexArray;
-extern GLuint ThresholdProgram;
-extern GLuint PreviousFramebuffer;
-extern GLuint PreviousTexture;
-extern GLuint CurrentFramebuffer;
 #define INVALID -2 // invalid value for uniforms/attributes
-extern GLuint CurrentTexture;
-extern int Score;
+extern GLuint ThresholdProgram;
+extern RenderGraph FrameGraph;
+extern int UnderBudgetFrames;
+extern int OverBudgetFrames;
+extern float64 MeanFrameTime;
+extern int WindowFrames;
+extern float64 LastWindowInterval;
+extern float64 WindowInterval;
+extern float64 FrameInterval;
+extern float32 RenderScale;
+extern M3 RenderProjection;
+extern int TargetHeight;
+extern int TargetWidth;
+extern RenderTarget *PreviousTarget;
+extern RenderTarget *CurrentTarget;
 extern float LineWidthPixels;
 extern int ScreenHeight;
 extern int ScreenWidth;
 extern GLuint ScreenRenderbuffer;
 extern GLuint ScreenFramebuffer;
-#define AsteroidSizeLarge 3
-#define AsteroidSizeMedium 2
-#define AsteroidSizeSmall 1
+typedef enum {
+    BlurLow,
+    BlurMedium,
+    BlurHigh,
+    BlurQualityCount,
+}BlurQualityTier;
+#define MaxBlurTaps 8 // MAX_TAPS in blur.fsh
+#define FrameIntervalWindow 60  // frames, see updateRenderScale()
+#define ScaleUpSettleFrames 240 // without GPU timers a higher scale is only tried after this long steady
+#define ScaleSettleFrames 30    // a load has to hold this long before the scale changes, longer than GPUTimerLatency
+#define SteadyLoad 1.02    // and this close to it
+#define DroppingLoad 1.1   // without GPU timers, a mean frame time this far past the interval
+#define ScaleUpLoad 0.6    // and below this raises it, the gap between them keeps it from flipping
+#define ScaleDownLoad 0.85 // of the frame interval, GPU time above this lowers the scale
+#define RenderScaleStep 0.125f
+#define MinRenderScale 0.5f
+#define WarmupFrames 2 // frames allowed to allocate before the DEBUG heap check
+#define FrameArenaSize (4 * 1024 * 1024)
+#define SegmentTextureWidth 256
 #define DecayConstant 0.5f // higher = longer trails
-#define ScoreIntensity 0.2
-#define ShipIntensity 0.2
-#define BulletIntensity 10.0
-#define AsteroidIntensity 0.2
-#define BulletInterval 0.2
-#define ExplosionParticleExpiration 1.0
-#define BulletExpiration 1.0
 #define INTERFACE 0
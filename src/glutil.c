@@ -32,8 +32,37 @@
         y = t;        \
     } while (0)
 
+#define MaxTextureUnits 4
+#define UnknownState -1 // nothing shadowed yet, the next set is always issued
+
+// the GL state last set through the set* functions below, so that setting
+// the current value again costs no call into the driver, state changed
+// directly with gl* calls has to be followed by invalidateGLState()
+typedef struct {
+    GLint Program;
+    GLint VertexArray;
+    GLint Framebuffer;
+    GLint ActiveUnit;
+    GLint Textures[MaxTextureUnits]; // GL_TEXTURE_2D of each unit
+    GLint Viewport[4];
+    GLint Blend;
+    GLint BlendSource;
+    GLint BlendDestination;
+    GLint Scissor;
+    GLint ScissorBox[4];
+
+    int Issued; // calls that changed state
+    int Skipped; // calls avoided since setup
+    int FrameIssued; // by the last frame, from endGLStateFrame()
+    int FrameSkipped;
+    int EndIssued; // the totals when the last frame ended
+    int EndSkipped;
+} GLStateCache;
+
 #endif
 
+GLStateCache GLState;
+
 char *GLErrorString(GLenum error) {
     switch (error) {
         case GL_FRAMEBUFFER_UNDEFINED:
@@ -76,11 +105,14 @@ void checkFramebuffer() {
     }
 }
 
+// markers also time the GPU work between them, see gputimer.c
 void glPushGroupMarker(char *str) {
     glPushGroupMarkerEXT(0, str);
+    pushGPUTimer(str);
 }
 
 void glPopGroupMarker() {
+    popGPUTimer();
     glPopGroupMarkerEXT();
 }
 
@@ -125,3 +157,142 @@ GLuint compileProgram(const char *const vertexShaderSource, const char *const fr
     glLabelObject(GL_PROGRAM_OBJECT_EXT, program, name);
     return program;
 }
+
+void invalidateGLState() {
+    GLState.Program = UnknownState;
+    GLState.VertexArray = UnknownState;
+    GLState.Framebuffer = UnknownState;
+    GLState.ActiveUnit = UnknownState;
+    for (int i = 0; i < MaxTextureUnits; i++) {
+        GLState.Textures[i] = UnknownState;
+    }
+    for (int i = 0; i < 4; i++) {
+        GLState.Viewport[i] = UnknownState;
+        GLState.ScissorBox[i] = UnknownState;
+    }
+    GLState.Blend = UnknownState;
+    GLState.BlendSource = UnknownState;
+    GLState.BlendDestination = UnknownState;
+    GLState.Scissor = UnknownState;
+}
+
+// count the calls issued and skipped since the last frame ended
+void endGLStateFrame() {
+    GLState.FrameIssued = GLState.Issued - GLState.EndIssued;
+    GLState.FrameSkipped = GLState.Skipped - GLState.EndSkipped;
+    GLState.EndIssued = GLState.Issued;
+    GLState.EndSkipped = GLState.Skipped;
+}
+
+// true if value has to be issued, recording it as current
+bool changeGLState(GLint *current, GLint value) {
+    if (*current == value) {
+        GLState.Skipped++;
+        return false;
+    }
+    *current = value;
+    GLState.Issued++;
+    return true;
+}
+
+void setProgram(GLuint program) {
+    if (changeGLState(&GLState.Program, program)) {
+        glUseProgram(program);
+    }
+}
+
+void setVertexArray(GLuint array) {
+    if (changeGLState(&GLState.VertexArray, array)) {
+        glBindVertexArray(array);
+    }
+}
+
+void setFramebuffer(GLuint framebuffer) {
+    if (changeGLState(&GLState.Framebuffer, framebuffer)) {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    }
+}
+
+// bind texture to GL_TEXTURE_2D of unit, also leaves unit active so that it
+// can be used to upload to texture
+void setTexture(int unit, GLuint texture) {
+    if (changeGLState(&GLState.ActiveUnit, unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+    if (changeGLState(&GLState.Textures[unit], texture)) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+    }
+}
+
+// deleting a bound texture unbinds it, after which its name may be reused
+void deleteTexture(GLuint texture) {
+    for (int i = 0; i < MaxTextureUnits; i++) {
+        if (GLState.Textures[i] == texture) {
+            GLState.Textures[i] = 0;
+        }
+    }
+    glDeleteTextures(1, &texture);
+}
+
+void deleteFramebuffer(GLuint framebuffer) {
+    if (GLState.Framebuffer == framebuffer) {
+        GLState.Framebuffer = 0;
+    }
+    glDeleteFramebuffers(1, &framebuffer);
+}
+
+void setViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    GLint *v = GLState.Viewport;
+    if (v[0] == x && v[1] == y && v[2] == width && v[3] == height) {
+        GLState.Skipped++;
+        return;
+    }
+    v[0] = x;
+    v[1] = y;
+    v[2] = width;
+    v[3] = height;
+    GLState.Issued++;
+    glViewport(x, y, width, height);
+}
+
+void setBlend(bool enabled) {
+    if (changeGLState(&GLState.Blend, enabled)) {
+        if (enabled) {
+            glEnable(GL_BLEND);
+        } else {
+            glDisable(GL_BLEND);
+        }
+    }
+}
+
+void setBlendFunc(GLenum source, GLenum destination) {
+    bool changed = changeGLState(&GLState.BlendSource, source);
+    changed = changeGLState(&GLState.BlendDestination, destination) || changed;
+    if (changed) {
+        glBlendFunc(source, destination);
+    }
+}
+
+void setScissor(bool enabled) {
+    if (changeGLState(&GLState.Scissor, enabled)) {
+        if (enabled) {
+            glEnable(GL_SCISSOR_TEST);
+        } else {
+            glDisable(GL_SCISSOR_TEST);
+        }
+    }
+}
+
+void setScissorBox(GLint x, GLint y, GLsizei width, GLsizei height) {
+    GLint *box = GLState.ScissorBox;
+    if (box[0] == x && box[1] == y && box[2] == width && box[3] == height) {
+        GLState.Skipped++;
+        return;
+    }
+    box[0] = x;
+    box[1] = y;
+    box[2] = width;
+    box[3] = height;
+    GLState.Issued++;
+    glScissor(x, y, width, height);
+}
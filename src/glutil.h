@@ -1,12 +1,51 @@
 /* This file was automatically generated.  Do not edit! */
+void setScissorBox(GLint x,GLint y,GLsizei width,GLsizei height);
+void setScissor(bool enabled);
+void setBlendFunc(GLenum source,GLenum destination);
+void setBlend(bool enabled);
+void setViewport(GLint x,GLint y,GLsizei width,GLsizei height);
+void deleteFramebuffer(GLuint framebuffer);
+void deleteTexture(GLuint texture);
+void setTexture(int unit,GLuint texture);
+void setFramebuffer(GLuint framebuffer);
+void setVertexArray(GLuint array);
+void setProgram(GLuint program);
+bool changeGLState(GLint *current,GLint value);
+void endGLStateFrame();
+void invalidateGLState();
 GLuint compileProgram(const char *const vertexShaderSource,const char *const fragmentShaderSource,char *name);
 GLuint compileShader(const char *const source,GLuint type);
 void glLabelObject(GLenum type,GLuint object,char *label);
+void popGPUTimer();
 void glPopGroupMarker();
+void pushGPUTimer(char *name);
 void glPushGroupMarker(char *str);
 void fatal(const char *fmt,...);
 void checkFramebuffer();
 char *GLErrorString(GLenum error);
+#define MaxTextureUnits 4
+typedef struct {
+    GLint Program;
+    GLint VertexArray;
+    GLint Framebuffer;
+    GLint ActiveUnit;
+    GLint Textures[MaxTextureUnits]; // GL_TEXTURE_2D of each unit
+    GLint Viewport[4];
+    GLint Blend;
+    GLint BlendSource;
+    GLint BlendDestination;
+    GLint Scissor;
+    GLint ScissorBox[4];
+
+    int Issued; // calls that changed state
+    int Skipped; // calls avoided since setup
+    int FrameIssued; // by the last frame, from endGLStateFrame()
+    int FrameSkipped;
+    int EndIssued; // the totals when the last frame ended
+    int EndSkipped;
+}GLStateCache;
+extern GLStateCache GLState;
+#define UnknownState -1 // nothing shadowed yet, the next set is always issued
 #define GLSWAP(x, y)  \
     do {              \
         GLuint t = x; \
@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if TARGET_OS_IPHONE
+#include <OpenGLES/ES3/gl.h>
+#include <OpenGLES/ES3/glext.h>
+#else
+#include <OpenGL/gl3.h>
+#include <OpenGL/glext.h>
+#endif
+
+#include "gputimer.h"
+
+#if INTERFACE
+
+#define GPUTimerLatency 4  // frames of queries in flight, results are read this many frames later
+#define MaxGPUPasses 16    // group markers timed per frame
+#define MaxGPUPassDepth 4  // nesting of group markers
+#define GPUTimerHistory 64 // samples per pass in the rolling table
+
+// a group marker in one frame, timed by a GL_TIMESTAMP query at each end
+typedef struct {
+    char *Name;
+    int Depth;
+    GLuint Begin;
+    GLuint End;
+} GPUPassQuery;
+
+typedef struct {
+    GPUPassQuery Passes[MaxGPUPasses];
+    int PassCount;
+} GPUTimerFrame;
+
+// the last GPUTimerHistory times of a pass, in ms
+typedef struct {
+    char *Name;
+    int Depth;
+    float64 Times[GPUTimerHistory];
+    int Count;
+    int Next;
+} GPUPassTimes;
+
+#endif
+
+// timestamp queries are core on desktop GL, iOS has no timer queries at all
+bool GPUTimersAvailable;
+
+GPUTimerFrame GPUTimerFrames[GPUTimerLatency];
+int GPUTimerFrameIndex;
+int GPUTimerStack[MaxGPUPassDepth]; // indices of the open passes, -1 if untimed
+int GPUTimerDepth;
+
+GPUPassTimes GPUPassTable[MaxGPUPasses]; // in the order passes were first seen
+int GPUPassCount;
+int GPUTimerDropped; // frames whose results weren't ready in time
+float64 GPUFrameTime;  // ms of the outermost passes of the last frame read back
+
+void setupGPUTimers() {
+#if !TARGET_OS_IPHONE
+    GLint bits = 0;
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+    GPUTimersAvailable = bits > 0;
+    if (!GPUTimersAvailable) {
+        return;
+    }
+
+    for (int f = 0; f < GPUTimerLatency; f++) {
+        for (int p = 0; p < MaxGPUPasses; p++) {
+            GPUPassQuery *pass = &GPUTimerFrames[f].Passes[p];
+            glGenQueries(1, &pass->Begin);
+            glGenQueries(1, &pass->End);
+        }
+    }
+#endif
+}
+
+GPUPassTimes *gpuPassTimes(char *name, int depth) {
+    for (int i = 0; i < GPUPassCount; i++) {
+        if (strcmp(GPUPassTable[i].Name, name) == 0) {
+            return &GPUPassTable[i];
+        }
+    }
+    if (GPUPassCount == MaxGPUPasses) {
+        return NULL;
+    }
+    GPUPassTimes *times = &GPUPassTable[GPUPassCount++];
+    *times = (GPUPassTimes){.Name = name, .Depth = depth};
+    return times;
+}
+
+// add the results of a frame GPUTimerLatency frames old to the table, a frame
+// the GPU hasn't finished yet is dropped rather than waited for
+void collectGPUTimerFrame(GPUTimerFrame *frame) {
+#if !TARGET_OS_IPHONE
+    if (frame->PassCount == 0) {
+        return;
+    }
+
+    for (int i = 0; i < frame->PassCount; i++) {
+        GLuint available = false;
+        glGetQueryObjectuiv(frame->Passes[i].End, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            GPUTimerDropped++;
+            frame->PassCount = 0;
+            return;
+        }
+    }
+
+    // markers with the same name, like repeated blur passes, add up to one
+    // sample for the frame
+    float64 sums[MaxGPUPasses] = {0};
+    bool seen[MaxGPUPasses] = {0};
+    float64 total = 0;
+    for (int i = 0; i < frame->PassCount; i++) {
+        GPUPassQuery *pass = &frame->Passes[i];
+        GLuint64 begin, end;
+        glGetQueryObjectui64v(pass->Begin, GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(pass->End, GL_QUERY_RESULT, &end);
+        if (pass->Depth == 0) {
+            total += (end - begin) * 1e-6;
+        }
+
+        GPUPassTimes *times = gpuPassTimes(pass->Name, pass->Depth);
+        if (times == NULL) {
+            continue;
+        }
+        int entry = times - GPUPassTable;
+        sums[entry] += (end - begin) * 1e-6;
+        seen[entry] = true;
+    }
+
+    for (int i = 0; i < GPUPassCount; i++) {
+        if (!seen[i]) {
+            continue;
+        }
+        GPUPassTimes *times = &GPUPassTable[i];
+        times->Times[times->Next] = sums[i];
+        times->Next = (times->Next + 1) % GPUTimerHistory;
+        if (times->Count < GPUTimerHistory) {
+            times->Count++;
+        }
+    }
+    GPUFrameTime = total;
+    frame->PassCount = 0;
+#endif
+}
+
+// before the frame's first group marker
+void beginGPUTimerFrame() {
+    if (!GPUTimersAvailable) {
+        return;
+    }
+    GPUTimerFrameIndex = (GPUTimerFrameIndex + 1) % GPUTimerLatency;
+    GPUTimerDepth = 0;
+    collectGPUTimerFrame(&GPUTimerFrames[GPUTimerFrameIndex]);
+}
+
+void pushGPUTimer(char *name) {
+#if !TARGET_OS_IPHONE
+    if (!GPUTimersAvailable) {
+        return;
+    }
+    GPUTimerFrame *frame = &GPUTimerFrames[GPUTimerFrameIndex];
+    int depth = GPUTimerDepth++;
+    if (depth >= MaxGPUPassDepth) {
+        return;
+    }
+    if (frame->PassCount == MaxGPUPasses) {
+        GPUTimerStack[depth] = -1;
+        return;
+    }
+
+    GPUPassQuery *pass = &frame->Passes[frame->PassCount];
+    pass->Name = name;
+    pass->Depth = depth;
+    glQueryCounter(pass->Begin, GL_TIMESTAMP);
+    GPUTimerStack[depth] = frame->PassCount++;
+#endif
+}
+
+void popGPUTimer() {
+#if !TARGET_OS_IPHONE
+    if (!GPUTimersAvailable || GPUTimerDepth == 0) {
+        return;
+    }
+    int depth = --GPUTimerDepth;
+    if (depth >= MaxGPUPassDepth || GPUTimerStack[depth] < 0) {
+        return;
+    }
+
+    GPUTimerFrame *frame = &GPUTimerFrames[GPUTimerFrameIndex];
+    glQueryCounter(frame->Passes[GPUTimerStack[depth]].End, GL_TIMESTAMP);
+#endif
+}
+
+void gpuPassStatistics(GPUPassTimes *times, float64 *average, float64 *max) {
+    float64 sum = 0;
+    *max = 0;
+    for (int i = 0; i < times->Count; i++) {
+        sum += times->Times[i];
+        if (times->Times[i] > *max) {
+            *max = times->Times[i];
+        }
+    }
+    *average = times->Count > 0 ? sum / times->Count : 0;
+}
+
+// one line of the table, the pass name indented by its nesting
+void formatGPUPassTimes(char *line, int length, GPUPassTimes *times) {
+    float64 average, max;
+    gpuPassStatistics(times, &average, &max);
+    snprintf(line, length, "%*s%-*s %6.3f %6.3f", times->Depth * 2, "", 20 - times->Depth * 2, times->Name, average, max);
+}
+
+// the table into the canvas with its top left corner at x, y
+void drawGPUTimes(int x, int y) {
+    char line[64];
+    if (!GPUTimersAvailable) {
+        drawText("no gpu timers", x, y - DrawFont.Height);
+        return;
+    }
+
+    snprintf(line, sizeof(line), "%-20s %6s %6s", "gpu ms", "avg", "max");
+    y -= DrawFont.Height;
+    drawText(line, x, y);
+    for (int i = 0; i < GPUPassCount; i++) {
+        formatGPUPassTimes(line, sizeof(line), &GPUPassTable[i]);
+        y -= DrawFont.Height;
+        drawText(line, x, y);
+    }
+}
+
+bool dumpGPUTimes(char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+
+    char line[64];
+    fprintf(file, "%-20s %6s %6s\n", "pass", "avg ms", "max ms");
+    for (int i = 0; i < GPUPassCount; i++) {
+        formatGPUPassTimes(line, sizeof(line), &GPUPassTable[i]);
+        fprintf(file, "%s\n", line);
+    }
+    fprintf(file, "%d frames dropped\n", GPUTimerDropped);
+    return fclose(file) == 0;
+}
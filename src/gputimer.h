@@ -0,0 +1,52 @@
+/* This file was automatically generated.  Do not edit! */
+bool dumpGPUTimes(char *path);
+typedef struct {
+    int Width;
+    int Height;
+    int Chars;
+    uint8_t *Data;
+}Font;
+extern Font DrawFont;
+void drawText(char *text,int x,int y);
+void drawGPUTimes(int x,int y);
+typedef double float64;
+#define GPUTimerHistory 64 // samples per pass in the rolling table
+typedef struct {
+    char *Name;
+    int Depth;
+    float64 Times[GPUTimerHistory];
+    int Count;
+    int Next;
+}GPUPassTimes;
+void formatGPUPassTimes(char *line,int length,GPUPassTimes *times);
+void gpuPassStatistics(GPUPassTimes *times,float64 *average,float64 *max);
+void popGPUTimer();
+void pushGPUTimer(char *name);
+void beginGPUTimerFrame();
+void frame(float64 t);
+typedef struct {
+    char *Name;
+    int Depth;
+    GLuint Begin;
+    GLuint End;
+}GPUPassQuery;
+#define MaxGPUPasses 16    // group markers timed per frame
+typedef struct {
+    GPUPassQuery Passes[MaxGPUPasses];
+    int PassCount;
+}GPUTimerFrame;
+void collectGPUTimerFrame(GPUTimerFrame *frame);
+GPUPassTimes *gpuPassTimes(char *name,int depth);
+void setupGPUTimers();
+extern float64 GPUFrameTime;
+extern int GPUTimerDropped;
+extern int GPUPassCount;
+extern GPUPassTimes GPUPassTable[MaxGPUPasses];
+extern int GPUTimerDepth;
+#define MaxGPUPassDepth 4  // nesting of group markers
+extern int GPUTimerStack[MaxGPUPassDepth];
+extern int GPUTimerFrameIndex;
+#define GPUTimerLatency 4  // frames of queries in flight, results are read this many frames later
+extern GPUTimerFrame GPUTimerFrames[GPUTimerLatency];
+extern bool GPUTimersAvailable;
+#define INTERFACE 0
@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include <stdbool.h>
+
+#if TARGET_OS_IPHONE
+#include <OpenGLES/ES3/gl.h>
+#include <OpenGLES/ES3/glext.h>
+#else
+#include <OpenGL/gl3.h>
+#include <OpenGL/glext.h>
+#endif
+
+#include "graph.h"
+
+#if INTERFACE
+
+#define MaxGraphResources 16
+#define MaxGraphPasses 16
+#define MaxPassResources 4
+
+// a render target as the graph sees it, imported ones are owned elsewhere and
+// outlive the frame, transient ones are taken from the pool at the first pass
+// writing them and given back after the last pass reading them, so that
+// transients whose lifetimes don't overlap share a target
+typedef struct {
+    char *Name;
+    int Width;
+    int Height;
+    GLenum Format;
+    GLenum Filter;
+    bool Imported;
+    RenderTarget *Target;
+    GLuint Framebuffer; // of Target, or the imported framebuffer
+    int FirstPass;      // of the passes that run, -1 if none use it
+    int LastPass;
+} GraphResource;
+
+typedef struct RenderGraph RenderGraph;
+typedef struct RenderPass RenderPass;
+
+struct RenderPass {
+    char *Name;
+    void (*Execute)(RenderGraph *graph, RenderPass *pass);
+    int Param; // for Execute
+    int Inputs[MaxPassResources];
+    int InputCount;
+    int Outputs[MaxPassResources];
+    int OutputCount;
+    bool Culled;
+};
+
+// the passes of one frame in the order added, rebuilt every frame
+struct RenderGraph {
+    GraphResource Resources[MaxGraphResources];
+    int ResourceCount;
+    RenderPass Passes[MaxGraphPasses];
+    int PassCount;
+    int CulledPasses;
+};
+
+#endif
+
+void resetRenderGraph(RenderGraph *graph) {
+    graph->ResourceCount = 0;
+    graph->PassCount = 0;
+    graph->CulledPasses = 0;
+}
+
+int addGraphResource(RenderGraph *graph, GraphResource resource) {
+    if (graph->ResourceCount == MaxGraphResources) {
+        fatal("too many render graph resources");
+    }
+    resource.FirstPass = -1;
+    resource.LastPass = -1;
+    graph->Resources[graph->ResourceCount] = resource;
+    return graph->ResourceCount++;
+}
+
+// a target kept across frames, passes writing it are never culled
+int importTarget(RenderGraph *graph, char *name, RenderTarget *target) {
+    return addGraphResource(graph, (GraphResource){
+                                       .Name = name,
+                                       .Width = target->Width,
+                                       .Height = target->Height,
+                                       .Imported = true,
+                                       .Target = target,
+                                       .Framebuffer = target->Framebuffer,
+                                   });
+}
+
+// a framebuffer outside the pool, like the screen's
+int importFramebuffer(RenderGraph *graph, char *name, GLuint framebuffer, int width, int height) {
+    return addGraphResource(graph, (GraphResource){
+                                       .Name = name,
+                                       .Width = width,
+                                       .Height = height,
+                                       .Imported = true,
+                                       .Framebuffer = framebuffer,
+                                   });
+}
+
+int createTransient(RenderGraph *graph, char *name, int width, int height, GLenum format, GLenum filter) {
+    return addGraphResource(graph, (GraphResource){
+                                       .Name = name,
+                                       .Width = width,
+                                       .Height = height,
+                                       .Format = format,
+                                       .Filter = filter,
+                                   });
+}
+
+RenderPass *addRenderPass(RenderGraph *graph, char *name, void (*execute)(RenderGraph *graph, RenderPass *pass), int param) {
+    if (graph->PassCount == MaxGraphPasses) {
+        fatal("too many render graph passes");
+    }
+    RenderPass *pass = &graph->Passes[graph->PassCount++];
+    *pass = (RenderPass){.Name = name, .Execute = execute, .Param = param};
+    return pass;
+}
+
+void readResource(RenderPass *pass, int resource) {
+    if (pass->InputCount == MaxPassResources) {
+        fatal("pass %s reads too many resources", pass->Name);
+    }
+    pass->Inputs[pass->InputCount++] = resource;
+}
+
+void writeResource(RenderPass *pass, int resource) {
+    if (pass->OutputCount == MaxPassResources) {
+        fatal("pass %s writes too many resources", pass->Name);
+    }
+    pass->Outputs[pass->OutputCount++] = resource;
+}
+
+// cull the passes nothing imported depends on, then find when each resource
+// is first and last used by the passes left
+void compileRenderGraph(RenderGraph *graph) {
+    bool needed[MaxGraphResources];
+    for (int r = 0; r < graph->ResourceCount; r++) {
+        needed[r] = graph->Resources[r].Imported;
+    }
+
+    for (int p = graph->PassCount - 1; p >= 0; p--) {
+        RenderPass *pass = &graph->Passes[p];
+        pass->Culled = true;
+        for (int i = 0; i < pass->OutputCount; i++) {
+            if (needed[pass->Outputs[i]]) {
+                pass->Culled = false;
+            }
+        }
+        if (pass->Culled) {
+            graph->CulledPasses++;
+            continue;
+        }
+        for (int i = 0; i < pass->InputCount; i++) {
+            needed[pass->Inputs[i]] = true;
+        }
+    }
+
+    for (int p = 0; p < graph->PassCount; p++) {
+        RenderPass *pass = &graph->Passes[p];
+        if (pass->Culled) {
+            continue;
+        }
+        for (int i = 0; i < pass->InputCount + pass->OutputCount; i++) {
+            int r = i < pass->InputCount ? pass->Inputs[i] : pass->Outputs[i - pass->InputCount];
+            GraphResource *resource = &graph->Resources[r];
+            if (resource->FirstPass == -1) {
+                resource->FirstPass = p;
+            }
+            resource->LastPass = p;
+        }
+    }
+}
+
+// run the passes left by compileRenderGraph(), each within a group marker
+void executeRenderGraph(RenderGraph *graph) {
+    for (int p = 0; p < graph->PassCount; p++) {
+        RenderPass *pass = &graph->Passes[p];
+        if (pass->Culled) {
+            continue;
+        }
+
+        for (int i = 0; i < pass->OutputCount; i++) {
+            GraphResource *resource = &graph->Resources[pass->Outputs[i]];
+            if (!resource->Imported && resource->Target == NULL) {
+                resource->Target = acquireRenderTarget(resource->Width, resource->Height, resource->Format, resource->Filter, resource->Name);
+                resource->Framebuffer = resource->Target->Framebuffer;
+            }
+        }
+
+        glPushGroupMarker(pass->Name);
+        pass->Execute(graph, pass);
+        glPopGroupMarker();
+
+        // outputs are acquired before inputs are released, so a pass never
+        // reads the target it writes
+        for (int r = 0; r < graph->ResourceCount; r++) {
+            GraphResource *resource = &graph->Resources[r];
+            if (!resource->Imported && resource->LastPass == p && resource->Target != NULL) {
+                releaseRenderTarget(resource->Target);
+                resource->Target = NULL;
+            }
+        }
+    }
+}
+
+// bind the pass's first output for drawing into all of it
+void bindPassOutput(RenderGraph *graph, RenderPass *pass) {
+    GraphResource *resource = &graph->Resources[pass->Outputs[0]];
+    setViewport(0, 0, resource->Width, resource->Height);
+    setFramebuffer(resource->Framebuffer);
+}
+
+GLuint passInput(RenderGraph *graph, RenderPass *pass, int input) {
+    GraphResource *resource = &graph->Resources[pass->Inputs[input]];
+    if (resource->Target == NULL) {
+        fatal("pass %s reads %s, which has no texture", pass->Name, resource->Name);
+    }
+    return resource->Target->Texture;
+}
@@ -0,0 +1,66 @@
+/* This file was automatically generated.  Do not edit! */
+typedef struct RenderGraph RenderGraph;
+typedef uint64_t uint64;
+typedef struct {
+    GLuint Texture;
+    GLuint Framebuffer;
+    int Width;
+    int Height;
+    GLenum Format; // sized internal format
+    GLenum Filter; // both min and mag
+    bool Acquired;
+    uint64 Released; // RenderTargetFrame when last released
+}RenderTarget;
+typedef struct {
+    char *Name;
+    int Width;
+    int Height;
+    GLenum Format;
+    GLenum Filter;
+    bool Imported;
+    RenderTarget *Target;
+    GLuint Framebuffer; // of Target, or the imported framebuffer
+    int FirstPass;      // of the passes that run, -1 if none use it
+    int LastPass;
+}GraphResource;
+#define MaxGraphResources 16
+typedef struct RenderPass RenderPass;
+#define MaxPassResources 4
+struct RenderPass {
+    char *Name;
+    void (*Execute)(RenderGraph *graph, RenderPass *pass);
+    int Param; // for Execute
+    int Inputs[MaxPassResources];
+    int InputCount;
+    int Outputs[MaxPassResources];
+    int OutputCount;
+    bool Culled;
+};
+#define MaxGraphPasses 16
+struct RenderGraph {
+    GraphResource Resources[MaxGraphResources];
+    int ResourceCount;
+    RenderPass Passes[MaxGraphPasses];
+    int PassCount;
+    int CulledPasses;
+};
+GLuint passInput(RenderGraph *graph,RenderPass *pass,int input);
+void setFramebuffer(GLuint framebuffer);
+void setViewport(GLint x,GLint y,GLsizei width,GLsizei height);
+void bindPassOutput(RenderGraph *graph,RenderPass *pass);
+void releaseRenderTarget(RenderTarget *target);
+void glPopGroupMarker();
+void glPushGroupMarker(char *str);
+RenderTarget *acquireRenderTarget(int width,int height,GLenum format,GLenum filter,char *name);
+void executeRenderGraph(RenderGraph *graph);
+void compileRenderGraph(RenderGraph *graph);
+void writeResource(RenderPass *pass,int resource);
+void readResource(RenderPass *pass,int resource);
+RenderPass *addRenderPass(RenderGraph *graph,char *name,void(*execute)(RenderGraph *graph,RenderPass *pass),int param);
+int createTransient(RenderGraph *graph,char *name,int width,int height,GLenum format,GLenum filter);
+int importFramebuffer(RenderGraph *graph,char *name,GLuint framebuffer,int width,int height);
+int importTarget(RenderGraph *graph,char *name,RenderTarget *target);
+void fatal(const char *fmt,...);
+int addGraphResource(RenderGraph *graph,GraphResource resource);
+void resetRenderGraph(RenderGraph *graph);
+#define INTERFACE 0
@@ -0,0 +1,138 @@
+// Runs the simulation without a window or GL context, for balancing, soak
+// tests and throughput runs over many games at once.  Built by build/build.go,
+// or by hand with:
+//
+//   cc -std=gnu11 -O2 -pthread -o asteroids-headless src/headless-main.c
+//      src/batch.c src/sim.c src/collision.c src/arena.c src/matrix.c
+//      src/model.c src/util.c src/common.c src/types.c src/profile.c -lm
+//
+// usage: asteroids-headless [ticks] [wave size] [games] [threads] [tick rate] [seed] [trace]
+//        asteroids-headless swept
+//
+// A run is reproducible from its seed, the default seed is the current time.
+// Given a trace path the run's CPU spans are written there as a Chrome trace,
+// only the last ones of each thread fit.  swept runs the bullet tunneling
+// regression scene instead and exits non-zero if it fails, build/build.go
+// runs it after each build.
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "headless-main.h"
+
+#define HeadlessAspect (16.0 / 9.0)
+
+float64 wallTime() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// sweptCollisionScene() in a game of its own
+bool checkSweptCollision() {
+    GameConfig config = Config;
+    config.TextCount = 0;
+    Game game;
+    setupSimulation(&game, config, createArena(gameArenaSize(config)), HeadlessAspect, 1);
+    return sweptCollisionScene(&game);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "swept") == 0) {
+        return checkSweptCollision() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    int64 ticks = 100000;
+    int wave = 4;
+    int count = 1;
+    int threads = 1;
+    uint64 seed = (uint64)time(NULL);
+    if (argc > 1) {
+        ticks = atoll(argv[1]);
+    }
+    if (argc > 2) {
+        wave = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        count = atoi(argv[3]);
+    }
+    if (argc > 4) {
+        threads = atoi(argv[4]);
+    }
+
+    // no score text, nothing would draw it
+    GameConfig config = Config;
+    if (argc > 5) {
+        config.TickRate = atoi(argv[5]);
+    }
+    if (argc > 6) {
+        seed = strtoull(argv[6], NULL, 10);
+    }
+    char *trace = argc > 7 ? argv[7] : NULL;
+    enableProfiler(trace != NULL);
+    config.AsteroidCount = wave * 8;
+    config.TextCount = 0;
+
+    Batch batch;
+    createBatch(&batch, count, config, threads, HeadlessAspect, seed);
+    batch.WaveSize = wave;
+
+    Random random = seedRandom(~seed);
+    GameInput *inputs = calloc(count, sizeof(GameInput));
+    GameObservation *observations = calloc(count, sizeof(GameObservation));
+
+    float64 start = wallTime();
+    for (int64 tick = 0; tick < ticks; tick++) {
+        // hold each random input for a while, like a player would
+        if (tick % 30 == 0) {
+            for (int i = 0; i < count; i++) {
+                bool left = Rand(&random, 0, 1) < 0.3;
+                inputs[i] = (GameInput){
+                    .Fire = Rand(&random, 0, 1) < 0.8,
+                    .Accelerate = Rand(&random, 0, 1) < 0.3,
+                    .RotateLeft = left,
+                    .RotateRight = !left && Rand(&random, 0, 1) < 0.3,
+                };
+            }
+        }
+
+        stepBatch(&batch, inputs, observations);
+    }
+    float64 elapsed = wallTime() - start;
+
+    int64 score = 0;
+    int64 waves = 0;
+    int64 cacheHits = 0;
+    int64 cacheMisses = 0;
+    int64 circleRejects = 0;
+    for (int i = 0; i < count; i++) {
+        score += observations[i].Score;
+        waves += observations[i].Wave;
+        cacheHits += batch.Games[i]->PolygonCacheHits;
+        cacheMisses += batch.Games[i]->PolygonCacheMisses;
+        circleRejects += batch.Games[i]->BoundingCircleRejects;
+    }
+
+    int64 steps = ticks * count;
+    printf("%d games on %d threads, %lld ticks in %.3f s, %.0f game ticks per second\n",
+           count, batch.WorkerCount, (long long)ticks, elapsed, steps / elapsed);
+    printf("seed %llu, mean score %.1f, mean waves %.1f\n", (unsigned long long)seed, (float64)score / count, (float64)waves / count);
+    printf("polygon cache %lld hits, %lld misses, %lld bounding circle rejects\n",
+           (long long)cacheHits, (long long)cacheMisses, (long long)circleRejects);
+
+    if (trace != NULL && !writeChromeTrace(trace)) {
+        printf("failed to write trace to %s\n", trace);
+    }
+
+    destroyBatch(&batch);
+    free(inputs);
+    free(observations);
+    return EXIT_SUCCESS;
+}
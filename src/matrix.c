@@ -121,11 +121,11 @@ V2 V2Project(V2 vl, V2 vr) {
 }
 
 V2 V2Maximum(V2 vl, V2 vr) {
-    return (V2){(vl.x > vr.x) ? vl.x : vr.x, (vl.y > vr.y) ? vl.x : vr.x};
+    return (V2){(vl.x > vr.x) ? vl.x : vr.x, (vl.y > vr.y) ? vl.y : vr.y};
 }
 
 V2 V2Minimum(V2 vl, V2 vr) {
-    return (V2){(vl.x < vr.x) ? vl.x : vr.x, (vl.y < vr.y) ? vl.x : vr.x};
+    return (V2){(vl.x < vr.x) ? vl.x : vr.x, (vl.y < vr.y) ? vl.y : vr.y};
 }
 
 float32 V3Length(V3 v) {
@@ -193,11 +193,11 @@ V3 V3Project(V3 vl, V3 vr) {
 }
 
 V3 V3Maximum(V3 vl, V3 vr) {
-    return (V3){(vl.x > vr.x) ? vl.x : vr.x, (vl.y > vr.y) ? vl.x : vr.x, (vl.z > vr.z) ? vl.x : vr.x};
+    return (V3){(vl.x > vr.x) ? vl.x : vr.x, (vl.y > vr.y) ? vl.y : vr.y, (vl.z > vr.z) ? vl.z : vr.z};
 }
 
 V3 V3Minimum(V3 vl, V3 vr) {
-    return (V3){(vl.x < vr.x) ? vl.x : vr.x, (vl.y < vr.y) ? vl.x : vr.x, (vl.z < vr.z) ? vl.x : vr.x};
+    return (V3){(vl.x < vr.x) ? vl.x : vr.x, (vl.y < vr.y) ? vl.y : vr.y, (vl.z < vr.z) ? vl.z : vr.z};
 }
 
 float32 V4Length(V4 v) {
@@ -265,11 +265,11 @@ V4 V4Project(V4 vl, V4 vr) {
 }
 
 V4 V4Maximum(V4 vl, V4 vr) {
-    return (V4){(vl.x > vr.x) ? vl.x : vr.x, (vl.y > vr.y) ? vl.x : vr.x, (vl.z > vr.z) ? vl.x : vr.x, (vl.w > vr.w) ? vl.x : vr.x};
+    return (V4){(vl.x > vr.x) ? vl.x : vr.x, (vl.y > vr.y) ? vl.y : vr.y, (vl.z > vr.z) ? vl.z : vr.z, (vl.w > vr.w) ? vl.w : vr.w};
 }
 
 V4 V4Minimum(V4 vl, V4 vr) {
-    return (V4){(vl.x < vr.x) ? vl.x : vr.x, (vl.y < vr.y) ? vl.x : vr.x, (vl.z < vr.z) ? vl.x : vr.x, (vl.w < vr.w) ? vl.x : vr.x};
+    return (V4){(vl.x < vr.x) ? vl.x : vr.x, (vl.y < vr.y) ? vl.y : vr.y, (vl.z < vr.z) ? vl.z : vr.z, (vl.w < vr.w) ? vl.w : vr.w};
 }
 
 const M3 M3Identity = {
@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#include "profile.h"
+
+#if INTERFACE
+
+#define ProfileEventCount 16384 // per thread, older events are overwritten
+#define MaxProfileThreads 16    // threads recording, later ones are ignored
+
+// the start or end of a span, Phase is 'B' or 'E' as in the Chrome trace format
+typedef struct {
+    const char *Name;
+    uint64 Time; // ns
+    char Phase;
+} ProfileEvent;
+
+// written only by its own thread, Written is published after each event so
+// that writeChromeTrace() can read the ring without locking
+typedef struct {
+    ProfileEvent Events[ProfileEventCount];
+    _Atomic uint64 Written;
+    int Thread;
+} ProfileBuffer;
+
+#endif
+
+// recording is off until enableProfiler(), spans then cost a relaxed load and
+// a branch
+atomic_bool ProfilerEnabled;
+
+// static so that no thread allocates while recording, untouched buffers are
+// never paged in
+ProfileBuffer ProfileBuffers[MaxProfileThreads];
+atomic_int ProfileThreadCount;
+_Thread_local ProfileBuffer *ThreadProfile;
+_Thread_local bool ThreadProfileFull; // every buffer was taken when this thread asked
+
+void enableProfiler(bool enabled) {
+    atomic_store_explicit(&ProfilerEnabled, enabled, memory_order_relaxed);
+}
+
+bool profilerEnabled() {
+    return atomic_load_explicit(&ProfilerEnabled, memory_order_relaxed);
+}
+
+uint64 profileTime() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+ProfileBuffer *threadProfileBuffer() {
+    if (ThreadProfile == NULL && !ThreadProfileFull) {
+        int thread = atomic_fetch_add(&ProfileThreadCount, 1);
+        if (thread >= MaxProfileThreads) {
+            ThreadProfileFull = true;
+            return NULL;
+        }
+        ThreadProfile = &ProfileBuffers[thread];
+        ThreadProfile->Thread = thread;
+    }
+    return ThreadProfile;
+}
+
+void recordProfileEvent(const char *name, char phase) {
+    ProfileBuffer *buffer = threadProfileBuffer();
+    if (buffer == NULL) {
+        return;
+    }
+    uint64 written = atomic_load_explicit(&buffer->Written, memory_order_relaxed);
+    ProfileEvent *event = &buffer->Events[written % ProfileEventCount];
+    event->Name = name;
+    event->Phase = phase;
+    event->Time = profileTime();
+    atomic_store_explicit(&buffer->Written, written + 1, memory_order_release);
+}
+
+// spans nest per thread, name has to outlive the trace, a string literal
+void pushProfile(const char *name) {
+    if (atomic_load_explicit(&ProfilerEnabled, memory_order_relaxed)) {
+        recordProfileEvent(name, 'B');
+    }
+}
+
+void popProfile() {
+    if (atomic_load_explicit(&ProfilerEnabled, memory_order_relaxed)) {
+        recordProfileEvent(NULL, 'E');
+    }
+}
+
+// write the recorded events of every thread as Chrome trace-event JSON, for
+// chrome://tracing or Perfetto, events of a thread still recording may be
+// missing their end
+bool writeChromeTrace(char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    int threads = atomic_load(&ProfileThreadCount);
+    if (threads > MaxProfileThreads) {
+        threads = MaxProfileThreads;
+    }
+    for (int t = 0; t < threads; t++) {
+        ProfileBuffer *buffer = &ProfileBuffers[t];
+        uint64 written = atomic_load_explicit(&buffer->Written, memory_order_acquire);
+        uint64 start = written > ProfileEventCount ? written - ProfileEventCount : 0;
+
+        // an end whose begin was overwritten would close a span of the caller
+        int depth = 0;
+        for (uint64 i = start; i < written; i++) {
+            ProfileEvent event = buffer->Events[i % ProfileEventCount];
+            if (event.Phase == 'E') {
+                if (depth == 0) {
+                    continue;
+                }
+                depth--;
+            } else {
+                depth++;
+            }
+
+            fprintf(file, "%s{\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%.3f", first ? "" : ",\n", event.Phase, t, event.Time * 1e-3);
+            if (event.Name != NULL) {
+                fprintf(file, ",\"name\":\"%s\"", event.Name);
+            }
+            fprintf(file, "}");
+            first = false;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    return fclose(file) == 0;
+}
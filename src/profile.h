@@ -0,0 +1,28 @@
+/* This file was automatically generated.  Do not edit! */
+bool writeChromeTrace(char *path);
+void popProfile();
+void pushProfile(const char *name);
+void recordProfileEvent(const char *name,char phase);
+typedef uint64_t uint64;
+typedef struct {
+    const char *Name;
+    uint64 Time; // ns
+    char Phase;
+}ProfileEvent;
+#define ProfileEventCount 16384 // per thread, older events are overwritten
+typedef struct {
+    ProfileEvent Events[ProfileEventCount];
+    _Atomic uint64 Written;
+    int Thread;
+}ProfileBuffer;
+ProfileBuffer *threadProfileBuffer();
+uint64 profileTime();
+bool profilerEnabled();
+void enableProfiler(bool enabled);
+extern _Thread_local bool ThreadProfileFull;
+extern _Thread_local ProfileBuffer *ThreadProfile;
+extern atomic_int ProfileThreadCount;
+#define MaxProfileThreads 16    // threads recording, later ones are ignored
+extern ProfileBuffer ProfileBuffers[MaxProfileThreads];
+extern atomic_bool ProfilerEnabled;
+#define INTERFACE 0
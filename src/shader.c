@@ -80,35 +80,25 @@ const char *const BlurFragmentSource = ""
                                        "uniform sampler2D tex;\n"
                                        "uniform bool horizontal;\n"
                                        "\n"
-                                       "// http://dev.theomader.com/gaussian-kernel-calculator/\n"
-                                       "// sigma=2 kernel=9\n"
-                                       "const float weight[5] = float[](0.20236, 0.179044, 0.124009, 0.067234, 0.028532);\n"
+                                       "// one side of a Gaussian kernel with neighbouring texels paired up, a bilinear\n"
+                                       "// fetch between the two at offsets[i] weighs them as the kernel does, so a\n"
+                                       "// radius of 4 takes 5 fetches instead of 9, set from blurKernel()\n"
+                                       "#define MAX_TAPS 8\n"
+                                       "uniform int tapCount;\n"
+                                       "uniform float offsets[MAX_TAPS];\n"
+                                       "uniform float weights[MAX_TAPS];\n"
                                        "\n"
                                        "out lowp vec4 color;\n"
                                        "\n"
                                        "void main() {\n"
-                                       "    ivec2 center = ivec2(gl_FragCoord.xy);\n"
+                                       "    vec2 size = vec2(textureSize(tex, 0));\n"
+                                       "    vec2 uv = gl_FragCoord.xy / size;\n"
+                                       "    vec2 direction = horizontal ? vec2(1.0 / size.x, 0.0) : vec2(0.0, 1.0 / size.y);\n"
                                        "\n"
-                                       "    vec3 result = texelFetch(tex, center, 0).rgb * weight[0];\n"
-                                       "\n"
-                                       "    if (horizontal) {\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(1, 0)).rgb * weight[1];\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(-1, 0)).rgb * weight[1];\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(2, 0)).rgb * weight[2];\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(-2, 0)).rgb * weight[2];\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(3, 0)).rgb * weight[3];\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(-3, 0)).rgb * weight[3];\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(4, 0)).rgb * weight[4];\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(-4, 0)).rgb * weight[4];\n"
-                                       "    } else {\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(0, 1)).rgb * weight[1];\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(0, -1)).rgb * weight[1];\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(0, 2)).rgb * weight[2];\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(0, -2)).rgb * weight[2];\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(0, 3)).rgb * weight[3];\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(0, -3)).rgb * weight[3];\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(0, 4)).rgb * weight[4];\n"
-                                       "        result += texelFetchOffset(tex, center, 0, ivec2(0, -4)).rgb * weight[4];\n"
+                                       "    vec3 result = texture(tex, uv).rgb * weights[0];\n"
+                                       "    for (int i = 1; i < tapCount; i++) {\n"
+                                       "        result += texture(tex, uv + direction * offsets[i]).rgb * weights[i];\n"
+                                       "        result += texture(tex, uv - direction * offsets[i]).rgb * weights[i];\n"
                                        "    }\n"
                                        "\n"
                                        "    color = vec4(result, 1.0);\n"
@@ -135,14 +125,14 @@ const char *const CanvasFragmentSource = ""
                                          "precision highp float;\n"
                                          "\n"
                                          "in highp vec2 fragUV;\n"
+                                         "in lowp vec4 fragColor;\n"
                                          "\n"
                                          "uniform sampler2D tex;\n"
-                                         "uniform vec4 color;\n"
                                          "\n"
                                          "out lowp vec4 outputColor;\n"
                                          "\n"
                                          "void main() {\n"
-                                         "    outputColor = color * texture(tex, fragUV);\n"
+                                         "    outputColor = fragColor * texture(tex, fragUV);\n"
                                          "}\n"
                                          "";
 const char *const CanvasVertexSource = ""
@@ -155,48 +145,19 @@ const char *const CanvasVertexSource = ""
                                        "\n"
                                        "in highp vec2 xy;\n"
                                        "in highp vec2 uv;\n"
+                                       "in lowp vec4 vertexColor;\n"
                                        "\n"
                                        "uniform vec2 resolution;\n"
                                        "\n"
                                        "out highp vec2 fragUV;\n"
+                                       "out lowp vec4 fragColor;\n"
                                        "\n"
                                        "void main() {\n"
                                        "    gl_Position = vec4((xy / resolution - 0.5) * 2.0, 0, 1);\n"
                                        "    fragUV = uv;\n"
+                                       "    fragColor = vertexColor;\n"
                                        "}\n"
                                        "";
-const char *const CopyFragmentSource = ""
-#if TARGET_OS_IPHONE
-                                       "#version 300 es\n"
-#else
-                                       "#version 330\n"
-#endif
-                                       "precision highp float;\n"
-                                       "\n"
-                                       "in highp vec2 uv;\n"
-                                       "\n"
-                                       "uniform sampler2D tex;\n"
-                                       "\n"
-                                       "out lowp vec4 color;\n"
-                                       "\n"
-                                       "void main() {\n"
-                                       "    color = texture(tex, uv);\n"
-                                       "}\n"
-                                       "";
-const char *const CopyVertexSource = ""
-#if TARGET_OS_IPHONE
-                                     "#version 300 es\n"
-#else
-                                     "#version 330\n"
-#endif
-                                     "in highp vec2 position;\n"
-                                     "out highp vec2 uv;\n"
-                                     "\n"
-                                     "void main() {\n"
-                                     "    gl_Position = vec4(position, 0, 1);\n"
-                                     "    uv = (position.xy + vec2(1, 1)) / 2.0;\n"
-                                     "}\n"
-                                     "";
 const char *const DecayFragmentSource = ""
 #if TARGET_OS_IPHONE
                                         "#version 300 es\n"
@@ -237,9 +198,9 @@ const char *const LineFragmentSource = ""
                                        "\n"
                                        "in vec2 screenStart;\n"
                                        "in vec2 screenEnd;\n"
+                                       "flat in float intensity;\n"
                                        "\n"
                                        "uniform float width;\n"
-                                       "uniform float intensity;\n"
                                        "\n"
                                        "out vec4 color;\n"
                                        "\n"
@@ -287,18 +248,37 @@ const char *const LineVertexSource = ""
 #endif
                                      "precision highp float;\n"
                                      "\n"
-                                     "in vec2 start;\n"
-                                     "in vec2 end;\n"
+                                     "// per instance\n"
+                                     "in mat3 transform;\n"
+                                     "in vec2 offset;\n"
+                                     "in float lineIntensity;\n"
+                                     "in ivec2 lineSegments; // first segment and how many of the drawn ones are used\n"
                                      "\n"
-                                     "uniform mat3 transform;\n"
                                      "uniform vec2 resolution;\n"
                                      "uniform float width;\n"
-                                     "uniform vec2 offset;\n"
+                                     "uniform highp sampler2D segments; // endpoints of one line segment per texel\n"
                                      "\n"
                                      "out vec2 screenStart;\n"
                                      "out vec2 screenEnd;\n"
+                                     "flat out float intensity;\n"
                                      "\n"
                                      "void main() {\n"
+                                     "    // instances with fewer segments than the draw, like short glyphs, collapse\n"
+                                     "    // the rest to a point outside the clip volume\n"
+                                     "    if (gl_VertexID / 6 >= lineSegments.y) {\n"
+                                     "        intensity = 0.0;\n"
+                                     "        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);\n"
+                                     "        return;\n"
+                                     "    }\n"
+                                     "\n"
+                                     "    // six vertices per segment make up its quad\n"
+                                     "    int segment = lineSegments.x + gl_VertexID / 6;\n"
+                                     "    int rowLength = textureSize(segments, 0).x;\n"
+                                     "    vec4 endpoints = texelFetch(segments, ivec2(segment % rowLength, segment / rowLength), 0);\n"
+                                     "    vec2 start = endpoints.xy;\n"
+                                     "    vec2 end = endpoints.zw;\n"
+                                     "\n"
+                                     "    intensity = lineIntensity;\n"
                                      "    vec2 clipStart = vec2(transform * vec3(start + offset, 1));\n"
                                      "    vec2 clipEnd = vec2(transform * vec3(end + offset, 1));\n"
                                      "    screenStart = (vec2(clipStart) + 1.0) / 2.0 * resolution;\n"
@@ -350,13 +330,27 @@ const char *const ThresholdFragmentSource = ""
                                             "\n"
                                             "#define THRESHOLD 0.5\n"
                                             "\n"
-                                            "void main() {\n"
-                                            "    vec3 pixel = texture(tex, uv).xyz;\n"
+                                            "// the bright part of the bilinear average of the 2x2 texels around at\n"
+                                            "vec3 threshold(vec2 at) {\n"
+                                            "    vec3 pixel = texture(tex, at).xyz;\n"
                                             "    if (pixel.x > THRESHOLD) {\n"
-                                            "        color = vec4((pixel - THRESHOLD) / (1.0 - THRESHOLD), 1.0);\n"
-                                            "    } else {\n"
-                                            "        color = vec4(0.0, 0.0, 0.0, 1.0);\n"
+                                            "        return (pixel - THRESHOLD) / (1.0 - THRESHOLD);\n"
+                                            "    }\n"
+                                            "    return vec3(0.0);\n"
+                                            "}\n"
+                                            "\n"
+                                            "// drawn at an eighth of the size of tex, each pixel averages its 8x8 block\n"
+                                            "// thresholded in 2x2 quads, the same as thresholding at half size and then\n"
+                                            "// halving twice but without the intermediate targets\n"
+                                            "void main() {\n"
+                                            "    vec2 texel = 1.0 / vec2(textureSize(tex, 0));\n"
+                                            "    vec3 sum = vec3(0.0);\n"
+                                            "    for (int y = -3; y <= 3; y += 2) {\n"
+                                            "        for (int x = -3; x <= 3; x += 2) {\n"
+                                            "            sum += threshold(uv + vec2(x, y) * texel);\n"
+                                            "        }\n"
                                             "    }\n"
+                                            "    color = vec4(sum / 16.0, 1.0);\n"
                                             "}\n"
                                             "";
 const char *const ThresholdVertexSource = ""
@@ -5,8 +5,6 @@ extern const char *const LineVertexSource;
 extern const char *const LineFragmentSource;
 extern const char *const DecayVertexSource;
 extern const char *const DecayFragmentSource;
-extern const char *const CopyVertexSource;
-extern const char *const CopyFragmentSource;
 extern const char *const CanvasVertexSource;
 extern const char *const CanvasFragmentSource;
 extern const char *const BlurVertexSource;
@@ -0,0 +1,663 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+
+#if INTERFACE
+
+#define EntityPoolCount 5
+#define MaxPolygonLength 32
+
+#define BulletExpiration 1.0
+#define ExplosionParticleExpiration 1.0
+#define BulletInterval 0.2
+
+#define ParticlesPerExplosion 64
+#define MaxTextLength 8 // characters in a text entity, including the terminator
+#define MaxTicksPerAdvance 8 // beyond this advanceSimulation() drops time rather than falling further behind
+
+#define AsteroidIntensity 0.2
+#define BulletIntensity 10.0
+#define ShipIntensity 0.2
+#define ScoreIntensity 0.2
+
+// pool sizes and tick rate, read once by setupSimulation()
+typedef struct {
+    int TickRate; // updates per second, independent of the display
+    int AsteroidCount;
+    int BulletCount;
+    int TextCount;
+    int ExplosionParticleCount;
+} GameConfig;
+
+// a single entity by value, used to spawn into an EntityPool
+typedef struct {
+    bool Active;
+    V2 Position;
+    V2 Velocity;
+    float32 Intensity;
+    float32 Rotation;      // radians
+    float32 RotationSpeed; // radians per second
+    Model Model;
+    float64 Created;
+    M3 Transform;
+    int AsteroidSize;
+} Entity;
+
+// structure-of-arrays storage for one kind of entity, so that the integration
+// pass in update() only streams through the fields it actually touches
+typedef struct {
+    int Count;
+    int FreeCount;
+    int *Free; // stack of inactive indices, spawnEntity pops and despawnEntity pushes
+    bool *Active;
+    V2 *Position;
+    V2 *Velocity;
+    float32 *Rotation;
+    V2 *PreviousPosition; // at the start of the last tick, for render interpolation
+    float32 *PreviousRotation;
+    float32 *RotationSpeed;
+    M3 *Transform;
+    float32 *Intensity;
+    float64 *Created;
+    Model *Model;
+    int *AsteroidSize;
+    float32 *Radius; // model space bounding radius around the model center
+
+    // per tick cache of the collision polygon, only allocated for pools that
+    // are tested with collision()
+    int PolygonStride;
+    uint64 *PolygonTick;
+    V2 *Polygon;
+
+    // only for the text pool, the string each entity shows, its Model only
+    // has the size
+    char (*Text)[MaxTextLength];
+} EntityPool;
+
+#define AsteroidSizeSmall 1
+#define AsteroidSizeMedium 2
+#define AsteroidSizeLarge 3
+
+// the player controls held during one update()
+typedef struct {
+    bool RotateLeft;
+    bool RotateRight;
+    bool Fire;
+    bool Accelerate;
+} GameInput;
+
+// all of the state of one running game, nothing in the simulation is global so
+// that any number of games can be stepped side by side
+typedef struct {
+    Arena Memory; // backs every EntityPool
+    EntityPool Asteroids;
+    EntityPool Bullets;
+    EntityPool Ship;
+    EntityPool ExplosionParticles;
+    EntityPool Texts;
+    Grid AsteroidGrid;
+    int ScoreText;  // index into Texts
+    int ShownScore; // the score ScoreText shows
+    M3 Projection;
+
+    Random Random;
+    RandomLanes ParticleRandom; // for bulk draws when spawning particles
+
+    GameInput Input;
+    int Score;
+    int Wave;
+    float64 Time;
+    float64 TickDuration;
+    float64 Accumulator; // time passed to advanceSimulation() not yet simulated
+    float64 LastBulletTime;
+    uint64 Tick; // number of update() calls, starts at 1 so that 0 is never current
+
+    // counters for checking the effectiveness of the polygon cache and
+    // bounding circle rejection under load
+    int PolygonCacheHits;
+    int PolygonCacheMisses;
+    int BoundingCircleRejects;
+} Game;
+
+#endif
+
+#define Scale 0.001
+
+// ship handling and fades were tuned as amounts per update at 60 Hz, update()
+// scales them by deltaT so that they play the same at any tick rate
+#define HandlingRate 60.0
+#define ShipTurn (3.0 / 180.0 * M_PI)
+#define ShipThrust 0.02
+#define ShipDrag 0.99
+#define ParticleFade 0.98
+
+// pool sizes of the interactive game, set before setup() to run with a
+// different mix of entities
+GameConfig Config = {
+    .TickRate = 120,
+    .AsteroidCount = 128,
+    .BulletCount = 3,
+    .TextCount = 16,
+    .ExplosionParticleCount = 256,
+};
+
+// the size of text laid out with BattleFont, the renderer draws the glyphs
+// itself so the model has no points
+Model measureText(char *text) {
+    Model textModel = {
+        .Height = BattleFont.Height,
+    };
+    for (int i = 0; text[i] != '\0'; i++) {
+        Model glyph = BattleFont.Characters[text[i]];
+        if (glyph.Data != NULL) {
+            textModel.Width += glyph.Width;
+        }
+    }
+    return textModel;
+}
+
+// carve the pool arrays out of the arena, each aligned for SIMD access, an
+// empty pool takes no memory
+void allocateEntityPool(Arena *arena, EntityPool *pool, int count, int polygonStride) {
+    *pool = (EntityPool){
+        .Count = count,
+        .Free = arenaPush(arena, count * sizeof(int)),
+        .Active = arenaPush(arena, count * sizeof(bool)),
+        .Position = arenaPush(arena, count * sizeof(V2)),
+        .Velocity = arenaPush(arena, count * sizeof(V2)),
+        .Rotation = arenaPush(arena, count * sizeof(float32)),
+        .PreviousPosition = arenaPush(arena, count * sizeof(V2)),
+        .PreviousRotation = arenaPush(arena, count * sizeof(float32)),
+        .RotationSpeed = arenaPush(arena, count * sizeof(float32)),
+        .Transform = arenaPush(arena, count * sizeof(M3)),
+        .Intensity = arenaPush(arena, count * sizeof(float32)),
+        .Created = arenaPush(arena, count * sizeof(float64)),
+        .Model = arenaPush(arena, count * sizeof(Model)),
+        .AsteroidSize = arenaPush(arena, count * sizeof(int)),
+        .Radius = arenaPush(arena, count * sizeof(float32)),
+        .PolygonStride = polygonStride,
+        .PolygonTick = arenaPush(arena, count * sizeof(uint64)),
+        .Polygon = arenaPush(arena, count * polygonStride * sizeof(V2)),
+    };
+}
+
+void allocateEntityPools(Arena *arena, Game *game, GameConfig config) {
+    allocateEntityPool(arena, &game->Asteroids, config.AsteroidCount, MaxPolygonLength);
+    allocateEntityPool(arena, &game->Bullets, config.BulletCount, 0);
+    allocateEntityPool(arena, &game->ExplosionParticles, config.ExplosionParticleCount, 0);
+    allocateEntityPool(arena, &game->Ship, 1, 0);
+    allocateEntityPool(arena, &game->Texts, config.TextCount, 0);
+    game->Texts.Text = arenaPush(arena, config.TextCount * MaxTextLength);
+}
+
+void gameEntityPools(Game *game, EntityPool *pools[EntityPoolCount]) {
+    pools[0] = &game->Asteroids;
+    pools[1] = &game->Bullets;
+    pools[2] = &game->ExplosionParticles;
+    pools[3] = &game->Ship;
+    pools[4] = &game->Texts;
+}
+
+// bytes of arena a game with this config needs for its entity pools
+memory_index gameArenaSize(GameConfig config) {
+    Arena measure = {};
+    Game game = {};
+    allocateEntityPools(&measure, &game, config);
+    return measure.Used;
+}
+
+// mark every entity inactive, pushing the indices in reverse so that the
+// lowest are handed out first
+void clearEntityPool(EntityPool *pool) {
+    for (int i = 0; i < pool->Count; i++) {
+        pool->Active[i] = false;
+        pool->Free[i] = pool->Count - 1 - i;
+    }
+    pool->FreeCount = pool->Count;
+}
+
+void setEntity(EntityPool *pool, int index, Entity e) {
+    pool->Active[index] = e.Active;
+    pool->Position[index] = e.Position;
+    pool->Velocity[index] = e.Velocity;
+    pool->Rotation[index] = e.Rotation;
+    pool->PreviousPosition[index] = e.Position;
+    pool->PreviousRotation[index] = e.Rotation;
+    pool->RotationSpeed[index] = e.RotationSpeed;
+    pool->Transform[index] = e.Transform;
+    pool->Intensity[index] = e.Intensity;
+    pool->Created[index] = e.Created;
+    pool->Model[index] = e.Model;
+    pool->AsteroidSize[index] = e.AsteroidSize;
+    pool->Radius[index] = modelRadius(e.Model);
+    pool->PolygonTick[index] = 0;
+}
+
+// take an inactive slot from the pool and store e in it, returns the index or
+// -1 if the pool is full
+int spawnEntity(EntityPool *pool, Entity e) {
+    if (pool->FreeCount == 0) {
+        return -1;
+    }
+    pool->FreeCount--;
+    int index = pool->Free[pool->FreeCount];
+    e.Active = true;
+    setEntity(pool, index, e);
+    return index;
+}
+
+void despawnEntity(EntityPool *pool, int index) {
+    if (!pool->Active[index]) {
+        return;
+    }
+    pool->Active[index] = false;
+    pool->Free[pool->FreeCount] = index;
+    pool->FreeCount++;
+}
+
+// start a new wave of large asteroids at random positions
+void spawnAsteroidWave(Game *game, int count) {
+    for (int i = 0; i < count; i++) {
+        Entity asteroid = {
+            .Active = true,
+            .Created = game->Time,
+            .Intensity = AsteroidIntensity,
+            .Position = (V2){Rand(&game->Random, -1.0, 1.0), Rand(&game->Random, -1.0, 1.0)},
+            .Velocity = (V2){Rand(&game->Random, -0.1, 0.1), Rand(&game->Random, -0.1, 0.1)},
+            .Model = ModelAsteroid4,
+            .AsteroidSize = AsteroidSizeLarge,
+        };
+        spawnEntity(&game->Asteroids, asteroid);
+    }
+    game->Wave++;
+}
+
+// create the entity pools in arena, which must hold at least
+// gameArenaSize(config) bytes, and the starting entities, aspect is the width
+// over the height of the playfield as it is shown, the same seed and inputs
+// always play out the same way
+void setupSimulation(Game *game, GameConfig config, Arena arena, float32 aspect, uint64 seed) {
+    *game = (Game){
+        .Memory = arena,
+        .Random = seedRandom(seed),
+        .TickDuration = 1.0 / config.TickRate,
+        .Projection = M3Scale(M3Identity, (V2){1.0 / aspect, 1.0}),
+    };
+    uint64 laneSeed = (uint64)nextRandom(&game->Random) << 32 | nextRandom(&game->Random);
+    game->ParticleRandom = seedRandomLanes(laneSeed);
+    allocateEntityPools(&game->Memory, game, config);
+
+    EntityPool *pools[EntityPoolCount];
+    gameEntityPools(game, pools);
+    for (int i = 0; i < EntityPoolCount; i++) {
+        clearEntityPool(pools[i]);
+    }
+
+    // every asteroid uses ModelAsteroid4, the grid is sized for all of them
+    // at full size so that it never grows mid game
+    reserveGrid(&game->AsteroidGrid, config.AsteroidCount, entityScale(AsteroidSizeLarge) * modelRadius(ModelAsteroid4));
+
+    spawnAsteroidWave(game, 1);
+
+    Entity ship = {
+        .Active = true,
+        .Intensity = ShipIntensity,
+        .Model = ModelShip,
+    };
+    spawnEntity(&game->Ship, ship);
+
+    Entity scoreText = {
+        .Active = true,
+        .Intensity = ScoreIntensity,
+        .Position = (V2){0.8, 0.8},
+    };
+    // -1 without texts, as in headless games
+    game->ScoreText = spawnEntity(&game->Texts, scoreText);
+    if (game->ScoreText != -1) {
+        setScoreText(game);
+    }
+}
+
+// update the score text, only needed when the score changes
+void setScoreText(Game *game) {
+    EntityPool *texts = &game->Texts;
+    char *text = texts->Text[game->ScoreText];
+    snprintf(text, MaxTextLength, "%d", game->Score);
+    texts->Model[game->ScoreText] = measureText(text);
+    game->ShownScore = game->Score;
+}
+
+void destroyAsteroid(Game *game, int asteroid) {
+    pushProfile("destroyAsteroid");
+    float64 t = game->Time;
+    V2 position = game->Asteroids.Position[asteroid];
+    int size = game->Asteroids.AsteroidSize[asteroid];
+
+    // two angles and an intensity for every particle
+    float32 random[ParticlesPerExplosion * 3];
+    fillRandom(&game->ParticleRandom, random, ParticlesPerExplosion * 3);
+    for (int k = 0; k < ParticlesPerExplosion; k++) {
+        float32 *r = &random[k * 3];
+
+        // generate random spherical direction
+        M4 rotation = M4Rotate(M4Identity, (r[0] - 0.5) * M_PI, (V3){1, 0, 0});
+        rotation = M4Rotate(rotation, r[1] * 2 * M_PI, (V3){0, 0, 1});
+        V3 direction = M4MultiplyV3(rotation, (V3){1, 0, 0});
+        V2 velocity = V2MultiplyScalar((V2){direction.x, direction.y}, 0.2);
+        Entity particle = {
+            .Active = true,
+            .Velocity = velocity,
+            .Position = position,
+            .Created = t,
+            .Intensity = 0.5 + r[2] * 0.3,
+            .Model = ModelBullet,
+        };
+        if (spawnEntity(&game->ExplosionParticles, particle) == -1) {
+            break;
+        }
+    }
+
+    if (size > AsteroidSizeSmall) {
+        // create two new asteroids
+        for (int asteroidNumber = 0; asteroidNumber < 2; asteroidNumber++) {
+            Entity child = {
+                .Active = true,
+                .Created = t,
+                .Intensity = AsteroidIntensity,
+                .Position = position,
+                .Velocity = (V2){Rand(&game->Random, -0.1, 0.1), Rand(&game->Random, -0.1, 0.1)},
+                .Model = ModelAsteroid4,
+                .AsteroidSize = size - 1,
+            };
+            spawnEntity(&game->Asteroids, child);
+        }
+    }
+
+    despawnEntity(&game->Asteroids, asteroid);
+    game->Score++;
+    popProfile();
+}
+
+float32 entityScale(int asteroidSize) {
+    if (asteroidSize == AsteroidSizeMedium) {
+        return Scale * 0.5;
+    } else if (asteroidSize == AsteroidSizeSmall) {
+        return Scale * 0.25;
+    }
+    return Scale;
+}
+
+// radius of a circle around the entity position that contains the whole model
+float32 entityRadius(EntityPool *pool, int index) {
+    return entityScale(pool->AsteroidSize[index]) * pool->Radius[index];
+}
+
+void integrateEntities(EntityPool *pool, float64 deltaT) {
+    bool *active = pool->Active;
+    V2 *position = pool->Position;
+    V2 *velocity = pool->Velocity;
+    float32 *rotation = pool->Rotation;
+    float32 *rotationSpeed = pool->RotationSpeed;
+
+    for (int i = 0; i < pool->Count; i++) {
+        if (!active[i]) {
+            continue;
+        }
+
+        rotation[i] = rotation[i] + rotationSpeed[i] * deltaT;
+        V2 pos = V2Add(position[i], V2MultiplyScalar(velocity[i], deltaT));
+
+        if (pos.x > 1) {
+            pos.x = pos.x - 2;
+        } else if (pos.x < -1) {
+            pos.x = pos.x + 2;
+        }
+
+        if (pos.y > 1) {
+            pos.y = pos.y - 2;
+        } else if (pos.y < -1) {
+            pos.y = pos.y + 2;
+        }
+
+        position[i] = pos;
+    }
+}
+
+// model to screen transform of an entity at the given position and rotation
+M3 entityTransform(const EntityPool *pool, int index, V2 position, float32 rotation, M3 projection) {
+    Model model = pool->Model[index];
+    float32 scale = entityScale(pool->AsteroidSize[index]);
+
+    // translate(position) * scale * rotate * translate(-center), folded by hand
+    // so that only the projection needs a full matrix multiply
+    V2 origin = (V2){(float)-model.Width / 2.0, (float)-model.Height / 2.0};
+    float32 c = cosf(rotation) * scale;
+    float32 s = sinf(rotation) * scale;
+    M3 local = {
+        c, s, 0,
+        -s, c, 0,
+        position.x + c * origin.x - s * origin.y, position.y + s * origin.x + c * origin.y, 1,
+    };
+    return M3Multiply(projection, local);
+}
+
+void transformEntities(EntityPool *pool, M3 projection) {
+    for (int i = 0; i < pool->Count; i++) {
+        if (!pool->Active[i]) {
+            continue;
+        }
+        pool->Transform[i] = entityTransform(pool, i, pool->Position[i], pool->Rotation[i], projection);
+    }
+}
+
+// transform of an entity a fraction alpha of the way from the start to the end
+// of the last tick, taking the short way around when it wrapped
+M3 interpolatedTransform(const EntityPool *pool, int index, float32 alpha, M3 projection) {
+    V2 previous = pool->PreviousPosition[index];
+    V2 delta = wrapDelta(V2Subtract(pool->Position[index], previous));
+    V2 position = V2Add(previous, V2MultiplyScalar(delta, alpha));
+    float32 rotation = pool->PreviousRotation[index] + (pool->Rotation[index] - pool->PreviousRotation[index]) * alpha;
+    return entityTransform(pool, index, position, rotation, projection);
+}
+
+// regression scene for bullet tunneling, fires at a column of small asteroids
+// while stepping the simulation at 10 Hz, true if every asteroid was destroyed
+bool sweptCollisionScene(Game *game) {
+    for (int i = 0; i < game->Asteroids.Count; i++) {
+        despawnEntity(&game->Asteroids, i);
+    }
+    for (int i = 0; i < game->Bullets.Count; i++) {
+        despawnEntity(&game->Bullets, i);
+    }
+
+    int asteroidCount = 4;
+    for (int i = 0; i < asteroidCount; i++) {
+        Entity asteroid = {
+            .Active = true,
+            .Created = -1.0,
+            .Intensity = AsteroidIntensity,
+            .Position = (V2){0, -0.5 + i * 0.3},
+            .Model = ModelAsteroid4,
+            .AsteroidSize = AsteroidSizeSmall,
+        };
+        spawnEntity(&game->Asteroids, asteroid);
+    }
+
+    game->Ship.Position[0] = (V2){0, -0.8};
+    game->Ship.Velocity[0] = (V2){0, 0};
+    game->Ship.Rotation[0] = 0;
+
+    int score = game->Score;
+    game->Input = (GameInput){.Fire = true};
+    for (int tick = 0; tick < 20; tick++) {
+        update(game, 0.1);
+    }
+    game->Input = (GameInput){};
+
+    int hit = game->Score - score;
+    printf("swept collision scene: %d of %d asteroids hit\n", hit, asteroidCount);
+    return hit == asteroidCount;
+}
+
+// advance the game by deltaT seconds using the controls in game->Input
+void update(Game *game, float64 deltaT) {
+    pushProfile("update");
+    game->Tick++;
+    game->Time += deltaT;
+    float64 t = game->Time;
+    float64 steps = deltaT * HandlingRate;
+
+    EntityPool *asteroids = &game->Asteroids;
+    EntityPool *bullets = &game->Bullets;
+    EntityPool *ship = &game->Ship;
+    EntityPool *particles = &game->ExplosionParticles;
+    GameInput input = game->Input;
+
+    EntityPool *pools[EntityPoolCount];
+    gameEntityPools(game, pools);
+    for (int i = 0; i < EntityPoolCount; i++) {
+        memcpy(pools[i]->PreviousPosition, pools[i]->Position, pools[i]->Count * sizeof(V2));
+        memcpy(pools[i]->PreviousRotation, pools[i]->Rotation, pools[i]->Count * sizeof(float32));
+    }
+
+    if (input.RotateLeft) {
+        ship->Rotation[0] = ship->Rotation[0] - ShipTurn * steps;
+    }
+
+    if (input.RotateRight) {
+        ship->Rotation[0] = ship->Rotation[0] + ShipTurn * steps;
+    }
+
+    ship->Velocity[0] = V2MultiplyScalar(ship->Velocity[0], pow(ShipDrag, steps));
+    if (input.Accelerate) {
+        // add velocity based on current direction
+        M3 transform = M3Rotate(M3Identity, ship->Rotation[0]);
+        V2 deltaV = M3MultiplyV2(transform, (V2){0, ShipThrust * steps});
+        ship->Velocity[0] = V2Add(ship->Velocity[0], deltaV);
+    }
+
+    if (input.Fire && t - game->LastBulletTime > BulletInterval) {
+        M3 transform = M3Rotate(M3Identity, ship->Rotation[0]);
+        V2 velocity = M3MultiplyV2(transform, (V2){0, 3});
+        V2 position = V2Add(ship->Position[0], M3MultiplyV2(transform, (V2){0, (float32)ModelShip.Height * Scale / 2.0}));
+        Entity bullet = {
+            .Active = true,
+            .Created = t,
+            .Intensity = BulletIntensity,
+            .Position = position,
+            .Velocity = velocity,
+            .Model = ModelBullet,
+        };
+        if (spawnEntity(bullets, bullet) != -1) {
+            game->LastBulletTime = t;
+        }
+    }
+
+    for (int i = 0; i < bullets->Count; i++) {
+        if (t - bullets->Created[i] > BulletExpiration) {
+            despawnEntity(bullets, i);
+        }
+    }
+
+    float32 fade = pow(ParticleFade, steps);
+    for (int i = 0; i < particles->Count; i++) {
+        if (!particles->Active[i]) {
+            continue;
+        }
+        if (t - particles->Created[i] > ExplosionParticleExpiration) {
+            despawnEntity(particles, i);
+            continue;
+        }
+
+        particles->Intensity[i] = particles->Intensity[i] * fade;
+    }
+
+    for (int i = 0; i < EntityPoolCount; i++) {
+        integrateEntities(pools[i], deltaT);
+        transformEntities(pools[i], game->Projection);
+    }
+
+    // check for intersection of bullets and the ship with asteroids, the grid
+    // limits the narrow phase to asteroids overlapping the same cell
+    pushProfile("collision");
+    Grid *grid = &game->AsteroidGrid;
+    buildGrid(grid, asteroids);
+
+    int cells[GridCellCount];
+    for (int i = 0; i < bullets->Count; i++) {
+        if (!bullets->Active[i]) {
+            continue;
+        }
+
+        // sweep the bullet from where it was at the start of the tick, so at
+        // large deltaT it can't step over a small asteroid
+        V2 end = bullets->Position[i];
+        V2 start = V2Subtract(end, V2MultiplyScalar(bullets->Velocity[i], deltaT));
+        int cellCount = gridCellsInBox(V2Minimum(start, end), V2Maximum(start, end), cells);
+
+        int hit = -1;
+        float32 nearest = 0;
+        for (int c = 0; c < cellCount; c++) {
+            for (int k = grid->CellStart[cells[c]]; k < grid->CellStart[cells[c] + 1]; k++) {
+                int j = grid->Items[k];
+                if (!asteroids->Active[j] || asteroids->Created[j] == t) {
+                    continue;
+                }
+
+                float32 fraction = sweptCollision(game, start, end, asteroids, j);
+                if (fraction >= 0 && (hit == -1 || fraction < nearest)) {
+                    hit = j;
+                    nearest = fraction;
+                }
+            }
+        }
+
+        if (hit != -1) {
+            destroyAsteroid(game, hit);
+            despawnEntity(bullets, i);
+        }
+    }
+
+    {
+        int cell = gridCell(ship->Position[0]);
+        for (int k = grid->CellStart[cell]; k < grid->CellStart[cell + 1]; k++) {
+            int j = grid->Items[k];
+            if (!asteroids->Active[j] || asteroids->Created[j] == t) {
+                continue;
+            }
+
+            if (collision(game, ship->Position[0], asteroids, j)) {
+                destroyAsteroid(game, j);
+            }
+        }
+    }
+    popProfile();
+
+    if (game->ScoreText != -1 && game->Score != game->ShownScore) {
+        setScoreText(game);
+    }
+    popProfile();
+}
+
+// run as many fixed ticks as fit in the time elapsed since the last call,
+// returns how far the leftover time is into the next tick for interpolation
+float32 advanceSimulation(Game *game, float64 elapsed) {
+    game->Accumulator += elapsed;
+    int ticks = 0;
+    while (game->Accumulator >= game->TickDuration) {
+        if (ticks == MaxTicksPerAdvance) {
+            game->Accumulator = 0;
+            break;
+        }
+        update(game, game->TickDuration);
+        game->Accumulator -= game->TickDuration;
+        ticks++;
+    }
+    return game->Accumulator / game->TickDuration;
+}
@@ -0,0 +1,214 @@
+/* This file was automatically generated.  Do not edit! */
+typedef float float32;
+typedef uint8_t uint8;
+typedef size_t memory_index;
+typedef struct {
+    uint8 *Base;
+    memory_index Size;
+    memory_index Used;
+}Arena;
+typedef union {
+    struct {
+        float32 x;
+        float32 y;
+    };
+    float32 m[2];
+}V2;
+typedef struct {
+    float32 m[9];
+}M3;
+typedef double float64;
+typedef struct {
+    int Width;
+    int Height;
+    int Length;
+    V2 *Data;
+}Model;
+typedef uint64_t uint64;
+#define MaxTextLength 8 // characters in a text entity, including the terminator
+typedef struct {
+    int Count;
+    int FreeCount;
+    int *Free; // stack of inactive indices, spawnEntity pops and despawnEntity pushes
+    bool *Active;
+    V2 *Position;
+    V2 *Velocity;
+    float32 *Rotation;
+    V2 *PreviousPosition; // at the start of the last tick, for render interpolation
+    float32 *PreviousRotation;
+    float32 *RotationSpeed;
+    M3 *Transform;
+    float32 *Intensity;
+    float64 *Created;
+    Model *Model;
+    int *AsteroidSize;
+    float32 *Radius; // model space bounding radius around the model center
+
+    // per tick cache of the collision polygon, only allocated for pools that
+    // are tested with collision()
+    int PolygonStride;
+    uint64 *PolygonTick;
+    V2 *Polygon;
+
+    // only for the text pool, the string each entity shows, its Model only
+    // has the size
+    char (*Text)[MaxTextLength];
+}EntityPool;
+#define GridSize 16 // cells per axis over the wrapped [-1, 1] playfield
+#define GridCellCount (GridSize * GridSize)
+typedef struct {
+    int CellStart[GridCellCount + 1]; // Items[CellStart[c]..CellStart[c + 1]] are in cell c
+    int Length;
+    int Capacity;
+    int *Items; // entity indices sorted by cell
+}Grid;
+typedef uint32_t uint32;
+typedef struct {
+    uint32 Words[4];
+}Random;
+#define RandomLaneCount 8
+typedef struct {
+    uint32 Words[4][RandomLaneCount];
+}RandomLanes;
+typedef struct {
+    bool RotateLeft;
+    bool RotateRight;
+    bool Fire;
+    bool Accelerate;
+}GameInput;
+typedef struct {
+    Arena Memory; // backs every EntityPool
+    EntityPool Asteroids;
+    EntityPool Bullets;
+    EntityPool Ship;
+    EntityPool ExplosionParticles;
+    EntityPool Texts;
+    Grid AsteroidGrid;
+    int ScoreText;  // index into Texts
+    int ShownScore; // the score ScoreText shows
+    M3 Projection;
+
+    Random Random;
+    RandomLanes ParticleRandom; // for bulk draws when spawning particles
+
+    GameInput Input;
+    int Score;
+    int Wave;
+    float64 Time;
+    float64 TickDuration;
+    float64 Accumulator; // time passed to advanceSimulation() not yet simulated
+    float64 LastBulletTime;
+    uint64 Tick; // number of update() calls, starts at 1 so that 0 is never current
+
+    // counters for checking the effectiveness of the polygon cache and
+    // bounding circle rejection under load
+    int PolygonCacheHits;
+    int PolygonCacheMisses;
+    int BoundingCircleRejects;
+}Game;
+float32 advanceSimulation(Game *game,float64 elapsed);
+bool collision(Game *game,V2 center,EntityPool *pool,int index);
+int gridCell(V2 position);
+float32 sweptCollision(Game *game,V2 start,V2 end,EntityPool *pool,int index);
+V2 V2Maximum(V2 vl,V2 vr);
+V2 V2Minimum(V2 vl,V2 vr);
+int gridCellsInBox(V2 min,V2 max,int *cells);
+void buildGrid(Grid *grid,EntityPool *pool);
+V2 M3MultiplyV2(M3 ml,V2 vr);
+M3 M3Rotate(M3 m,float32 radians);
+void update(Game *game,float64 deltaT);
+bool sweptCollisionScene(Game *game);
+V2 V2Subtract(V2 vl,V2 vr);
+V2 wrapDelta(V2 delta);
+M3 interpolatedTransform(const EntityPool *pool,int index,float32 alpha,M3 projection);
+void transformEntities(EntityPool *pool,M3 projection);
+M3 M3Multiply(M3 ml,M3 mr);
+M3 entityTransform(const EntityPool *pool,int index,V2 position,float32 rotation,M3 projection);
+V2 V2Add(V2 vl,V2 vr);
+void integrateEntities(EntityPool *pool,float64 deltaT);
+float32 entityRadius(EntityPool *pool,int index);
+void popProfile();
+extern Model ModelBullet;
+V2 V2MultiplyScalar(V2 v,float32 s);
+typedef union {
+    struct {
+        float32 x;
+        float32 y;
+        float32 z;
+    };
+    float32 m[3];
+}V3;
+typedef struct {
+    float32 m[16];
+}M4;
+V3 M4MultiplyV3(M4 m,V3 v);
+extern const M4 M4Identity;
+M4 M4Rotate(M4 m,float32 radians,V3 axis);
+void fillRandom(RandomLanes *lanes,float32 *values,int count);
+void pushProfile(const char *name);
+void destroyAsteroid(Game *game,int asteroid);
+void setScoreText(Game *game);
+extern Model ModelShip;
+float32 entityScale(int asteroidSize);
+void reserveGrid(Grid *grid,int count,float32 radius);
+RandomLanes seedRandomLanes(uint64 seed);
+uint32 nextRandom(Random *random);
+extern const M3 M3Identity;
+M3 M3Scale(M3 m,V2 v);
+Random seedRandom(uint64 seed);
+typedef struct {
+    int TickRate; // updates per second, independent of the display
+    int AsteroidCount;
+    int BulletCount;
+    int TextCount;
+    int ExplosionParticleCount;
+}GameConfig;
+void setupSimulation(Game *game,GameConfig config,Arena arena,float32 aspect,uint64 seed);
+extern Model ModelAsteroid4;
+float32 Rand(Random *random,float32 min,float32 max);
+void spawnAsteroidWave(Game *game,int count);
+void despawnEntity(EntityPool *pool,int index);
+typedef struct {
+    bool Active;
+    V2 Position;
+    V2 Velocity;
+    float32 Intensity;
+    float32 Rotation;      // radians
+    float32 RotationSpeed; // radians per second
+    Model Model;
+    float64 Created;
+    M3 Transform;
+    int AsteroidSize;
+}Entity;
+int spawnEntity(EntityPool *pool,Entity e);
+float32 modelRadius(Model model);
+void setEntity(EntityPool *pool,int index,Entity e);
+void clearEntityPool(EntityPool *pool);
+memory_index gameArenaSize(GameConfig config);
+#define EntityPoolCount 5
+void gameEntityPools(Game *game,EntityPool *pools[EntityPoolCount]);
+void allocateEntityPools(Arena *arena,Game *game,GameConfig config);
+void *arenaPush(Arena *arena,memory_index size);
+void allocateEntityPool(Arena *arena,EntityPool *pool,int count,int polygonStride);
+typedef struct {
+	int Height;
+	int Length;
+	Model Characters[];
+}ModelFont;
+extern ModelFont BattleFont;
+Model measureText(char *text);
+extern GameConfig Config;
+#define AsteroidSizeLarge 3
+#define AsteroidSizeMedium 2
+#define AsteroidSizeSmall 1
+#define ScoreIntensity 0.2
+#define ShipIntensity 0.2
+#define BulletIntensity 10.0
+#define AsteroidIntensity 0.2
+#define MaxTicksPerAdvance 8 // beyond this advanceSimulation() drops time rather than falling further behind
+#define ParticlesPerExplosion 64
+#define BulletInterval 0.2
+#define ExplosionParticleExpiration 1.0
+#define BulletExpiration 1.0
+#define MaxPolygonLength 32
+#define INTERFACE 0
@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if TARGET_OS_IPHONE
+#include <OpenGLES/ES3/gl.h>
+#include <OpenGLES/ES3/glext.h>
+#else
+#include <OpenGL/gl3.h>
+#include <OpenGL/glext.h>
+#endif
+
+#include "stream.h"
+
+#if INTERFACE
+
+#define StreamFrameCount 3     // frames the GPU may still be reading while the next is written
+#define StreamAlignment 16     // enough for any vertex attribute offset
+#define StreamFenceTimeout 1e6 // ns per wait, the wait repeats until the fence is signaled
+
+// one buffer split into StreamFrameCount regions written in turn, each frame
+// maps its region once and sub-allocates every dynamic vertex stream from it,
+// a fence per region keeps the CPU from overwriting what the GPU still reads
+typedef struct {
+    GLuint Buffer;
+    GLsizeiptr FrameSize;
+    int Frame;
+    GLsync Fences[StreamFrameCount];
+    Arena *Scratch; // per frame memory, holds the written data while the buffer grows
+
+    // the frame being written, offsets from streamAlloc() are relative to Base
+    GLintptr Base;
+    uint8 *Mapped;
+    GLsizeiptr Used;
+
+    GLsizeiptr FrameBytes; // streamed by the last finished frame
+    uint64 TotalBytes;
+    int Stalls; // frames that had to wait for the GPU to release their region
+} StreamBuffer;
+
+#endif
+
+void createStreamBuffer(StreamBuffer *stream, GLsizeiptr frameSize, Arena *scratch, char *label) {
+    *stream = (StreamBuffer){
+        .FrameSize = (frameSize + StreamAlignment - 1) & ~(GLsizeiptr)(StreamAlignment - 1),
+        .Frame = StreamFrameCount - 1,
+        .Scratch = scratch,
+    };
+    glGenBuffers(1, &stream->Buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, stream->Buffer);
+    glLabelObject(GL_BUFFER_OBJECT_EXT, stream->Buffer, label);
+    glBufferData(GL_ARRAY_BUFFER, stream->FrameSize * StreamFrameCount, NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void waitStreamFence(StreamBuffer *stream, int frame) {
+    GLsync fence = stream->Fences[frame];
+    if (fence == NULL) {
+        return;
+    }
+
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        stream->Stalls++;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, StreamFenceTimeout);
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+    if (result == GL_WAIT_FAILED) {
+        fatal("failed waiting for stream fence");
+    }
+    glDeleteSync(fence);
+    stream->Fences[frame] = NULL;
+}
+
+void mapStreamRegion(StreamBuffer *stream) {
+    stream->Base = stream->Frame * stream->FrameSize;
+    glBindBuffer(GL_ARRAY_BUFFER, stream->Buffer);
+    stream->Mapped = glMapBufferRange(GL_ARRAY_BUFFER, stream->Base, stream->FrameSize,
+                                      GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (stream->Mapped == NULL) {
+        fatal("failed to map %ld byte stream region", (long)stream->FrameSize);
+    }
+}
+
+// map the stream's region for the next frame, the GPU is only waited for if it
+// is more than StreamFrameCount - 1 frames behind
+void beginStreamFrame(StreamBuffer *stream) {
+    stream->Frame = (stream->Frame + 1) % StreamFrameCount;
+    stream->Used = 0;
+    waitStreamFence(stream, stream->Frame);
+    mapStreamRegion(stream);
+}
+
+// the region is too small for this frame, so replace the buffer with one at
+// least twice the size, keeping what was already written at the same offsets,
+// glBufferData() orphans the old storage so draws still reading it are safe
+void growStreamBuffer(StreamBuffer *stream, GLsizeiptr needed) {
+    void *written = arenaPush(stream->Scratch, stream->Used);
+    memcpy(written, stream->Mapped, stream->Used);
+
+    glBindBuffer(GL_ARRAY_BUFFER, stream->Buffer);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    while (stream->FrameSize < needed) {
+        stream->FrameSize *= 2;
+    }
+    glBufferData(GL_ARRAY_BUFFER, stream->FrameSize * StreamFrameCount, NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    mapStreamRegion(stream);
+    memcpy(stream->Mapped, written, stream->Used);
+}
+
+// reserve size bytes in the current frame, *data is where to write them and
+// is only valid until the next streamAlloc(), the return value is the offset
+// from stream->Base to use once the frame has ended
+GLintptr streamAlloc(StreamBuffer *stream, GLsizeiptr size, void **data) {
+    GLintptr offset = (stream->Used + StreamAlignment - 1) & ~(GLintptr)(StreamAlignment - 1);
+    if (offset + size > stream->FrameSize) {
+        growStreamBuffer(stream, offset + size);
+    }
+    stream->Used = offset + size;
+    *data = stream->Mapped + offset;
+    return offset;
+}
+
+// unmap the frame's region, nothing can be allocated until the next frame but
+// the region can now be drawn from
+void endStreamFrame(StreamBuffer *stream) {
+    glBindBuffer(GL_ARRAY_BUFFER, stream->Buffer);
+    if (stream->Used > 0) {
+        glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, stream->Used);
+    }
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    stream->Mapped = NULL;
+
+    stream->FrameBytes = stream->Used;
+    stream->TotalBytes += stream->Used;
+}
+
+// after the last draw reading the frame's region
+void fenceStreamFrame(StreamBuffer *stream) {
+    stream->Fences[stream->Frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
@@ -0,0 +1,42 @@
+/* This file was automatically generated.  Do not edit! */
+#define StreamFrameCount 3     // frames the GPU may still be reading while the next is written
+typedef uint8_t uint8;
+typedef size_t memory_index;
+typedef struct {
+    uint8 *Base;
+    memory_index Size;
+    memory_index Used;
+}Arena;
+typedef uint64_t uint64;
+typedef struct {
+    GLuint Buffer;
+    GLsizeiptr FrameSize;
+    int Frame;
+    GLsync Fences[StreamFrameCount];
+    Arena *Scratch; // per frame memory, holds the written data while the buffer grows
+
+    // the frame being written, offsets from streamAlloc() are relative to Base
+    GLintptr Base;
+    uint8 *Mapped;
+    GLsizeiptr Used;
+
+    GLsizeiptr FrameBytes; // streamed by the last finished frame
+    uint64 TotalBytes;
+    int Stalls; // frames that had to wait for the GPU to release their region
+}StreamBuffer;
+void fenceStreamFrame(StreamBuffer *stream);
+void endStreamFrame(StreamBuffer *stream);
+GLintptr streamAlloc(StreamBuffer *stream,GLsizeiptr size,void **data);
+void *arenaPush(Arena *arena,memory_index size);
+void growStreamBuffer(StreamBuffer *stream,GLsizeiptr needed);
+void beginStreamFrame(StreamBuffer *stream);
+void mapStreamRegion(StreamBuffer *stream);
+void fatal(const char *fmt,...);
+typedef double float64;
+void frame(float64 t);
+void waitStreamFence(StreamBuffer *stream,int frame);
+void glLabelObject(GLenum type,GLuint object,char *label);
+void createStreamBuffer(StreamBuffer *stream,GLsizeiptr frameSize,Arena *scratch,char *label);
+#define StreamFenceTimeout 1e6 // ns per wait, the wait repeats until the fence is signaled
+#define StreamAlignment 16     // enough for any vertex attribute offset
+#define INTERFACE 0
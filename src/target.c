@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdbool.h>
+
+#if TARGET_OS_IPHONE
+#include <OpenGLES/ES3/gl.h>
+#include <OpenGLES/ES3/glext.h>
+#else
+#include <OpenGL/gl3.h>
+#include <OpenGL/glext.h>
+#endif
+
+#include "target.h"
+
+#if INTERFACE
+
+#define MaxRenderTargets 16
+#define RenderTargetMaxAge 120 // frames a released target is kept for reuse
+
+// a texture and the framebuffer rendering into it, owned by the pool and
+// handed out by acquireRenderTarget() until released
+typedef struct {
+    GLuint Texture;
+    GLuint Framebuffer;
+    int Width;
+    int Height;
+    GLenum Format; // sized internal format
+    GLenum Filter; // both min and mag
+    bool Acquired;
+    uint64 Released; // RenderTargetFrame when last released
+} RenderTarget;
+
+#endif
+
+// targets are keyed by size, format and filter, a released target is reused
+// by the next acquire with the same key, and deleted once unused for
+// RenderTargetMaxAge frames, so a resize leaves no targets behind
+RenderTarget RenderTargets[MaxRenderTargets];
+uint64 RenderTargetFrame;
+int64 RenderTargetBytes; // texture memory held by the pool
+
+int renderTargetPixelSize(GLenum format) {
+    switch (format) {
+        case GL_RGBA8:
+            return 4;
+        case GL_RGBA16F:
+            return 8;
+    }
+    fatal("unsupported render target format %x", format);
+    return 0;
+}
+
+void createRenderTarget(RenderTarget *target, int width, int height, GLenum format, GLenum filter, char *name) {
+    *target = (RenderTarget){
+        .Width = width,
+        .Height = height,
+        .Format = format,
+        .Filter = filter,
+        .Acquired = true,
+    };
+
+    glGenFramebuffers(1, &target->Framebuffer);
+    setFramebuffer(target->Framebuffer);
+    glLabelObject(GL_FRAMEBUFFER, target->Framebuffer, name);
+
+    glGenTextures(1, &target->Texture);
+    setTexture(0, target->Texture);
+    glLabelObject(GL_TEXTURE, target->Texture, name);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLenum type = format == GL_RGBA16F ? GL_HALF_FLOAT : GL_UNSIGNED_BYTE;
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, GL_RGBA, type, NULL);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target->Texture, 0);
+
+    checkFramebuffer();
+    RenderTargetBytes += (int64)width * height * renderTargetPixelSize(format);
+}
+
+void destroyRenderTarget(RenderTarget *target) {
+    deleteFramebuffer(target->Framebuffer);
+    deleteTexture(target->Texture);
+    RenderTargetBytes -= (int64)target->Width * target->Height * renderTargetPixelSize(target->Format);
+    *target = (RenderTarget){0};
+}
+
+// a target nobody else holds, made if none with this key is free, name only
+// labels a newly made one
+RenderTarget *acquireRenderTarget(int width, int height, GLenum format, GLenum filter, char *name) {
+    RenderTarget *empty = NULL;
+    RenderTarget *oldest = NULL;
+    for (int i = 0; i < MaxRenderTargets; i++) {
+        RenderTarget *target = &RenderTargets[i];
+        if (target->Texture == 0) {
+            if (empty == NULL) {
+                empty = target;
+            }
+            continue;
+        }
+        if (target->Acquired) {
+            continue;
+        }
+        if (target->Width == width && target->Height == height && target->Format == format && target->Filter == filter) {
+            target->Acquired = true;
+            return target;
+        }
+        if (oldest == NULL || target->Released < oldest->Released) {
+            oldest = target;
+        }
+    }
+
+    // a full pool gives up the free target unused the longest
+    if (empty == NULL) {
+        if (oldest == NULL) {
+            fatal("all %d render targets are in use", MaxRenderTargets);
+        }
+        destroyRenderTarget(oldest);
+        empty = oldest;
+    }
+    createRenderTarget(empty, width, height, format, filter, name);
+    return empty;
+}
+
+void releaseRenderTarget(RenderTarget *target) {
+    target->Acquired = false;
+    target->Released = RenderTargetFrame;
+}
+
+// once per frame, after its last release
+void trimRenderTargets() {
+    RenderTargetFrame++;
+    for (int i = 0; i < MaxRenderTargets; i++) {
+        RenderTarget *target = &RenderTargets[i];
+        if (target->Texture != 0 && !target->Acquired && RenderTargetFrame - target->Released > RenderTargetMaxAge) {
+            destroyRenderTarget(target);
+        }
+    }
+}
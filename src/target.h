@@ -0,0 +1,32 @@
+/* This file was automatically generated.  Do not edit! */
+void trimRenderTargets();
+typedef uint64_t uint64;
+typedef struct {
+    GLuint Texture;
+    GLuint Framebuffer;
+    int Width;
+    int Height;
+    GLenum Format; // sized internal format
+    GLenum Filter; // both min and mag
+    bool Acquired;
+    uint64 Released; // RenderTargetFrame when last released
+}RenderTarget;
+void releaseRenderTarget(RenderTarget *target);
+RenderTarget *acquireRenderTarget(int width,int height,GLenum format,GLenum filter,char *name);
+void deleteTexture(GLuint texture);
+void deleteFramebuffer(GLuint framebuffer);
+void destroyRenderTarget(RenderTarget *target);
+void checkFramebuffer();
+void setTexture(int unit,GLuint texture);
+void glLabelObject(GLenum type,GLuint object,char *label);
+void setFramebuffer(GLuint framebuffer);
+void createRenderTarget(RenderTarget *target,int width,int height,GLenum format,GLenum filter,char *name);
+void fatal(const char *fmt,...);
+int renderTargetPixelSize(GLenum format);
+typedef int64_t int64;
+extern int64 RenderTargetBytes;
+extern uint64 RenderTargetFrame;
+#define MaxRenderTargets 16
+extern RenderTarget RenderTargets[MaxRenderTargets];
+#define RenderTargetMaxAge 120 // frames a released target is kept for reuse
+#define INTERFACE 0
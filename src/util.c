@@ -1,8 +1,103 @@
-#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 
 #include "util.h"
 
-float32 Rand(float32 min, float32 max) {
-    float32 r = ((float)rand() / (float)(RAND_MAX));
+#if INTERFACE
+
+#define RandomLaneCount 8
+
+// xoshiro128+ generator, small enough that every game carries its own and a
+// run can be replayed from its seed
+typedef struct {
+    uint32 Words[4];
+} Random;
+
+// RandomLaneCount xoshiro128+ generators stepped side by side, stored lane
+// minor so that the compiler can do one step of every lane in a few vector
+// instructions
+typedef struct {
+    uint32 Words[4][RandomLaneCount];
+} RandomLanes;
+
+#endif
+
+uint64 splitMix64(uint64 *x) {
+    uint64 z = (*x += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+uint32 rotateLeft(uint32 x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+// expand seed with splitmix64 as recommended for xoshiro, so that nearby seeds
+// give unrelated sequences
+Random seedRandom(uint64 seed) {
+    Random random;
+    for (int i = 0; i < 4; i += 2) {
+        uint64 z = splitMix64(&seed);
+        random.Words[i] = (uint32)z;
+        random.Words[i + 1] = (uint32)(z >> 32);
+    }
+    return random;
+}
+
+RandomLanes seedRandomLanes(uint64 seed) {
+    RandomLanes lanes;
+    for (int l = 0; l < RandomLaneCount; l++) {
+        for (int i = 0; i < 4; i += 2) {
+            uint64 z = splitMix64(&seed);
+            lanes.Words[i][l] = (uint32)z;
+            lanes.Words[i + 1][l] = (uint32)(z >> 32);
+        }
+    }
+    return lanes;
+}
+
+uint32 nextRandom(Random *random) {
+    uint32 *s = random->Words;
+    uint32 result = s[0] + s[3];
+    uint32 t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotateLeft(s[3], 11);
+    return result;
+}
+
+// uniform in [min, max), from the top 24 bits which are the well mixed ones
+float32 Rand(Random *random, float32 min, float32 max) {
+    float32 r = (nextRandom(random) >> 8) * 0x1.0p-24f;
     return (max - min) * r + min;
-}
\ No newline at end of file
+}
+
+// fill values with count uniform numbers in [0, 1), RandomLaneCount at a time
+void fillRandom(RandomLanes *lanes, float32 *values, int count) {
+    uint32 *s0 = lanes->Words[0];
+    uint32 *s1 = lanes->Words[1];
+    uint32 *s2 = lanes->Words[2];
+    uint32 *s3 = lanes->Words[3];
+
+    for (int i = 0; i < count; i += RandomLaneCount) {
+        float32 block[RandomLaneCount];
+        for (int l = 0; l < RandomLaneCount; l++) {
+            uint32 result = s0[l] + s3[l];
+            uint32 t = s1[l] << 9;
+            s2[l] ^= s0[l];
+            s3[l] ^= s1[l];
+            s1[l] ^= s2[l];
+            s0[l] ^= s3[l];
+            s2[l] ^= t;
+            s3[l] = rotateLeft(s3[l], 11);
+            block[l] = (result >> 8) * 0x1.0p-24f;
+        }
+
+        int length = count - i < RandomLaneCount ? count - i : RandomLaneCount;
+        memcpy(&values[i], block, length * sizeof(float32));
+    }
+}
@@ -1,3 +1,19 @@
 /* This file was automatically generated.  Do not edit! */
+typedef uint32_t uint32;
+#define RandomLaneCount 8
+typedef struct {
+    uint32 Words[4][RandomLaneCount];
+}RandomLanes;
 typedef float float32;
-float32 Rand(float32 min,float32 max);
+void fillRandom(RandomLanes *lanes,float32 *values,int count);
+typedef struct {
+    uint32 Words[4];
+}Random;
+float32 Rand(Random *random,float32 min,float32 max);
+uint32 nextRandom(Random *random);
+typedef uint64_t uint64;
+RandomLanes seedRandomLanes(uint64 seed);
+Random seedRandom(uint64 seed);
+uint32 rotateLeft(uint32 x,int k);
+uint64 splitMix64(uint64 *x);
+#define INTERFACE 0